@@ -0,0 +1,7 @@
+.section .rodata.bench,"a",@progbits
+
+.global bench_donut_data
+bench_donut_data: .incbin "bench.chr.donut"
+
+.global bench_zx02_data
+bench_zx02_data: .incbin "bench.nam.zx02"
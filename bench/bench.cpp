@@ -0,0 +1,199 @@
+#include "automino.hpp"
+#include "board.hpp"
+#include "common.hpp"
+#include "donut.hpp"
+#include "polyomino.hpp"
+#include "rng.hpp"
+#include "utils.hpp"
+#include "zx02.hpp"
+#include <neslib.h>
+#include <stdio.h>
+#include <time.h>
+
+// Times hot routines on a fixed board; on mos-sim, clock() counts CPU
+// cycles. Each routine is called a number of times with varying inputs and
+// its average cost is printed as "name,cycles,calls,limit" for
+// tools/bench-check; routines with a cycle budget in the game also get a
+// row with their worst call and that budget as its limit.
+
+extern "C" const char bench_donut_data[];
+extern "C" const char bench_zx02_data[];
+
+// kept global so the calls writing to it aren't optimized away
+u8 bench_text[5];
+volatile u16 bench_bcd;
+volatile u8 bench_byte;
+
+static constexpr u16 BENCH_SEED = 0x2a5c;
+
+// a level 1 drop speed, for the automino's reachable placements
+static constexpr u8 DROP_FRAMES = 120;
+
+// cost of the clock() calls around each timed call
+static u32 clock_overhead;
+
+// returns the worst call's cost
+template <typename Setup, typename Func>
+static u32 benchmark(const char *name, u16 calls, Setup setup, Func func) {
+  u32 total = 0;
+  u32 worst = 0;
+  for (u16 i = 0; i < calls; i++) {
+    setup(i);
+    clock_t start = clock();
+    func(i);
+    u32 elapsed = (u32)(clock() - start);
+    elapsed = elapsed > clock_overhead ? elapsed - clock_overhead : 0;
+    total += elapsed;
+    if (elapsed > worst) {
+      worst = elapsed;
+    }
+  }
+  printf("%s,%lu,%u,\n", name, (unsigned long)(total / calls), calls);
+  return worst;
+}
+
+template <typename Func>
+static u32 benchmark(const char *name, u16 calls, Func func) {
+  return benchmark(name, calls, [](u16) {}, func);
+}
+
+// the worst call of a routine that must fit a budget
+static void worst_case(const char *name, u32 worst, u16 calls, u16 limit) {
+  printf("%s (worst),%lu,%u,%u\n", name, (unsigned long)worst, calls, limit);
+}
+
+// how rand_up_to drew numbers before Rng, from neslib's rand8: a mask and
+// two tries, then a (biased) subtraction; n goes up to 18
+static const u8 rand8_mask[] = {0x00, 0x00, 0x01, 0x03, 0x03, 0x07, 0x07,
+                                0x07, 0x07, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f,
+                                0x0f, 0x0f, 0x0f, 0x1f, 0x1f};
+
+__attribute__((noinline)) static u8 rand8_up_to(u8 n) {
+  if (n < 2) {
+    return 0;
+  }
+  u8 result = rand8() & rand8_mask[n];
+  if (result >= n) {
+    result = rand8() & rand8_mask[n];
+  }
+  if (result >= n) {
+    result -= n;
+  }
+  return result;
+}
+
+// same maze, blocks and RNG state on every run: stage 0's maze with its
+// bottom rows partially filled
+static void board_fixture() {
+  Rng::seed(BENCH_SEED);
+  current_stage = Stage::StarlitStables;
+  board.reset();
+  for (u8 row = HEIGHT - 4; row < HEIGHT; row++) {
+    for (u8 column = 0; column < WIDTH; column++) {
+      if ((u8)(row + column) % 3 != 0) {
+        board.occupy(row, column);
+      }
+    }
+  }
+}
+
+struct Benchmark {
+  static void polyomino() {
+    board_fixture();
+    Polyomino polyomino(board);
+    polyomino.init();
+    polyomino.spawn();
+    benchmark("Polyomino::collide", 2 * HEIGHT * WIDTH,
+              [&polyomino](u16 i) {
+                polyomino.collide((s8)((i >> 1) % HEIGHT),
+                                  (s8)((i >> 1) / HEIGHT));
+              });
+    benchmark("Polyomino::update_shadow", WIDTH, [&polyomino](u16 i) {
+      polyomino.column = (s8)i;
+      polyomino.update_bitmask();
+      polyomino.update_shadow();
+    });
+  }
+
+  // a whole search takes several frames, each a step at a time; think()
+  // counts each step as Automino::STEP_CYCLES, so none may cost more
+  static void automino() {
+    board_fixture();
+    Polyomino polyomino(board);
+    polyomino.init();
+    Automino automino;
+    automino.drop_frames = DROP_FRAMES;
+    benchmark("Automino::search", NUM_POLYOMINOS, [&](u16 i) {
+      polyomino.next = polyominos[(u8)i];
+      automino.start(polyomino);
+      while (automino.search_step()) {
+      }
+    });
+    bool searching = false;
+    u32 worst = benchmark("Automino::search_step", 256, [&](u16 i) {
+      if (!searching) {
+        polyomino.next = polyominos[(u8)(i % NUM_POLYOMINOS)];
+        automino.start(polyomino);
+      }
+      searching = automino.search_step();
+    });
+    worst_case("Automino::search_step", worst, 256, Automino::STEP_CYCLES);
+  }
+
+  static void board_routines() {
+    board_fixture();
+    benchmark("Board::set_maze_cell", HEIGHT * WIDTH, [](u16 i) {
+      board.set_maze_cell((u8)(i / WIDTH), (u8)(i % WIDTH),
+                          i & 1 ? CellType::Marshmallow : CellType::Maze);
+    });
+    benchmark("Board::generate_maze", NUM_STAGES, [](u16 i) {
+      current_stage = (Stage)i;
+      board.generate_maze();
+    });
+  }
+
+  static void utils() {
+    // the neslib path the game used to take, next to Rng's; bounded draws
+    // stay within what rand8_up_to handles
+    set_rand(BENCH_SEED);
+    benchmark("rand8", 256, [](u16) { bench_byte = (u8)rand8(); });
+    benchmark("rand8_up_to", 256,
+              [](u16 i) { bench_byte = rand8_up_to((u8)(i % 19)); });
+    Rng::seed(BENCH_SEED);
+    benchmark("Rng::next", 256, [](u16) { bench_byte = Rng::next(); });
+    benchmark(
+        "Rng::next (pooled)", 256, [](u16) { Rng::refill(); },
+        [](u16) { bench_byte = Rng::next(); });
+    benchmark(
+        "Rng::refill", 256, [](u16) { Rng::next(); },
+        [](u16) { Rng::refill(); });
+    benchmark("Rng::up_to", 256,
+              [](u16 i) { bench_byte = Rng::up_to((u8)(i % 19)); });
+    benchmark("bcd_to_text", 256,
+              [](u16 i) { bcd_to_text(bench_text, (u16)(i * 0x39)); });
+    benchmark("bcd_add", 256,
+              [](u16 i) { bench_bcd = bcd_add((u16)(i * 0x39), (u8)i); });
+  }
+
+  static void decoders() {
+    benchmark("Donut::decompress_to_ppu", 4, [](u16) {
+      Donut::decompress_to_ppu((void *)bench_donut_data, BENCH_DONUT_BLOCKS);
+    });
+    benchmark("zx02_decompress_to_vram", 4, [](u16) {
+      zx02_decompress_to_vram((void *)bench_zx02_data, NAMETABLE_A);
+    });
+  }
+};
+
+int main() {
+  clock_t start = clock();
+  clock_overhead = (u32)(clock() - start);
+
+  printf("name,cycles,calls,limit\n");
+  Benchmark::polyomino();
+  Benchmark::automino();
+  Benchmark::board_routines();
+  Benchmark::utils();
+  Benchmark::decoders();
+  return 0;
+}
@@ -1,20 +1,49 @@
 .linecont +
 .include "ggsound.inc"
 
+;With SOUND_PROFILE, the update is timed as Mesen watches (see
+;START_MESEN_WATCH in src/log.hpp): "nmi sound" around all of it, and one
+;watch per active stream, plus the queue and the upload.
+.ifdef SOUND_PROFILE
+.include "watch-labels.inc"
+.endif
+
+;Write a watch id to the start/stop port; clobbers a.
+.macro mesen_watch_start id
+    .ifdef SOUND_PROFILE
+    lda #id
+    sta $4020
+    .endif
+.endmacro
+
+.macro mesen_watch_stop id
+    .ifdef SOUND_PROFILE
+    lda #id
+    sta $4021
+    .endif
+.endmacro
+
 ; ported from llvm-mos asm code
 
 .segment "_pnmi_p200"
     lda sound_disable_update
     bne sound_update_disabled
+    mesen_watch_start watch_id_nmi_sound
     .global get_prg_bank, set_prg_bank    
     jsr get_prg_bank
     pha
     lda sound_bank
     jsr set_prg_bank
+    mesen_watch_start watch_id_sound_queue
+    jsr sound_flush_queue
+    mesen_watch_stop watch_id_sound_queue
     jsr sound_update
+    mesen_watch_start watch_id_sound_upload
     jsr sound_upload
+    mesen_watch_stop watch_id_sound_upload
     pla
     jsr set_prg_bank
+    mesen_watch_stop watch_id_nmi_sound
 sound_update_disabled:
 
 .segment "_pinit_p200"
@@ -69,6 +98,11 @@ sound_bank: .res 1
 
 .segment "BSS"
 
+;Commands queued from C++ since the last update (see sound_flush_queue).
+sound_queue_song: .res 1
+sound_queue_pause: .res 1
+sound_queue_sfx: .res MAX_SFX_STREAMS
+
 stream_flags:                  .res MAX_STREAMS
 stream_note:                   .res MAX_STREAMS
 stream_note_length_lo:         .res MAX_STREAMS
@@ -272,6 +306,11 @@ song_stream_register_copy_loop:
     and #STREAM_ACTIVE_TEST
     beq song_stream_not_active
 
+    .ifdef SOUND_PROFILE
+    lda sound_stream_watch_ids,x
+    sta $4020
+    .endif
+
     ;Update the stream.
     jsr stream_update
 
@@ -290,6 +329,11 @@ song_stream_register_copy_loop:
     sta apu_register_sets+2,y
     lda stream_channel_register_4,x
     sta apu_register_sets+3,y
+
+    .ifdef SOUND_PROFILE
+    lda sound_stream_watch_ids,x
+    sta $4021
+    .endif
 song_stream_not_active:
 
     inx
@@ -305,6 +349,11 @@ sfx_stream_register_copy_loop:
     and #STREAM_ACTIVE_TEST
     beq sfx_stream_not_active
 
+    .ifdef SOUND_PROFILE
+    lda sound_stream_watch_ids,x
+    sta $4020
+    .endif
+
     ;Update the stream.
     jsr stream_update
 
@@ -323,6 +372,11 @@ sfx_stream_register_copy_loop:
     sta apu_register_sets+2,y
     lda stream_channel_register_4,x
     sta apu_register_sets+3,y
+
+    .ifdef SOUND_PROFILE
+    lda sound_stream_watch_ids,x
+    sta $4021
+    .endif
 sfx_stream_not_active:
 
     inx
@@ -340,6 +394,20 @@ sfx_stream_not_active:
     rts
 .endproc
 
+.ifdef SOUND_PROFILE
+;Watch id of each stream, in stream order.
+sound_stream_watch_ids:
+    .byte watch_id_sound_square_1
+    .byte watch_id_sound_square_2
+    .byte watch_id_sound_triangle
+    .byte watch_id_sound_noise
+    .ifdef FEATURE_DPCM
+    .byte watch_id_sound_dpcm
+    .endif
+    .byte watch_id_sound_sfx_1
+    .byte watch_id_sound_sfx_2
+.endif
+
 ;Note table borrowed from periods.s provided by FamiTracker's NSF driver.
 ntsc_note_table_lo:
     .byte <$0D5B, <$0C9C, <$0BE6, <$0B3B, <$0A9A, <$0A01, <$0972, <$08EA, <$086A, <$07F1, <$077F, <$0713
@@ -1894,6 +1962,68 @@ next_stream:
 
 .endproc
 
+;Runs the commands queued since the last update, so that however many sound
+;calls a frame makes, they share the update's bank switch. Each queue byte
+;is 0 when empty; sound_queue_song and sound_queue_sfx hold an index + 1, and
+;play_sfx in src/ggsound.cpp has already picked one effect per stream.
+.proc sound_flush_queue
+
+    ;Most frames queue nothing at all.
+    lda sound_queue_song
+    ora sound_queue_pause
+    .repeat MAX_SFX_STREAMS, i
+    ora sound_queue_sfx+i
+    .endrepeat
+    bne flush
+    rts
+flush:
+
+    lda sound_queue_song
+    beq no_song
+    sec
+    sbc #1
+    sta sound_param_byte_0
+    lda #0
+    sta sound_queue_song
+    jsr play_song
+no_song:
+
+    lda sound_queue_pause
+    beq no_pause
+    ldx #0
+    stx sound_queue_pause
+    cmp #SOUND_QUEUE_PAUSE
+    bne resume
+    jsr pause_song
+    jmp no_pause
+resume:
+    jsr resume_song
+no_pause:
+
+    ldx #0
+next_sfx:
+    lda sound_queue_sfx,x
+    beq no_sfx
+    sec
+    sbc #1
+    sta sound_param_byte_0
+    lda #0
+    sta sound_queue_sfx,x
+    txa
+    clc
+    adc #soundeffect_one
+    sta sound_param_byte_1
+    ;play_sfx keeps x.
+    jsr play_sfx
+no_sfx:
+    inx
+    cpx #MAX_SFX_STREAMS
+    bne next_sfx
+
+    rts
+
+.endproc
+
 ;Expects sound_param_byte_0 to contain the channel on which to play the stream.
 ;Expects sound_param_byte_1 to contain the offset of the stream instance to initialize.
 ;Expects sound_param_word_0 to contain the starting read address of the stream to
@@ -2044,6 +2174,11 @@ process_opcode:
 
 process_note:
 
+    .ifdef SOUND_SKIP_HIDDEN_ENVELOPES
+    jsr stream_hidden
+    bcs skip_channel_callback
+    .endif
+
     ;Determine which channel callback to use.
     lda stream_channel,x
     tay
@@ -2054,6 +2189,7 @@ process_note:
 
     ;Call the channel callback!
     jsr indirect_jsr_callback_address
+skip_channel_callback:
 
     sec
     lda stream_tempo_counter_lo,x
@@ -2136,6 +2272,46 @@ note_length_counter_not_zero:
 
 .endproc
 
+.ifdef SOUND_SKIP_HIDDEN_ENVELOPES
+;Tells whether the channel callback (arpeggio, volume, pitch and duty
+;envelopes) of a stream can be skipped this frame, because nobody would
+;hear what it writes: a square music stream silenced until its next note,
+;which restarts every envelope and reloads the pitch, so nothing the
+;callback does meanwhile carries over. A stream under a sound effect on
+;its channel isn't skipped: its envelopes must keep going, for when the
+;effect ends before its note does. Triangle and noise streams aren't
+;silenced after a sound effect, so they go on as usual.
+;Expects x to be the stream; returns carry set to skip the callback.
+.proc stream_hidden
+
+    ;Only music streams.
+    cpx #soundeffect_one
+    bcs audible
+
+    ;Only squares, which are channels 0 and 1.
+    lda stream_channel,x
+    cmp #2
+    bcs audible
+
+    ;Only silenced ones.
+    lda stream_flags,x
+    and #STREAM_SILENCE_TEST
+    beq audible
+
+    ;Keep the volume at 0, as the callback would.
+    lda stream_channel_register_1,x
+    and #%11000000
+    ora #%00110000
+    sta stream_channel_register_1,x
+    sec
+    rts
+
+audible:
+    clc
+    rts
+.endproc
+.endif
+
 .proc sound_initialize_apu_buffer
 
     ;****************************************************************
@@ -192,3 +192,176 @@ function(add_zx02_asset)
   )
   add_custom_target(${BASE_NAME} DEPENDS ${ASSET_DEST})
 endfunction()
+
+# Encodes SOURCE as a tools/chr-patcher patch over BASE (which must also be
+# added with add_donut_asset), writing <SOURCE>.patch
+function(add_chr_patch_asset)
+  set(options)
+  set(oneValueArgs SOURCE BASE)
+  set(multiValueArgs)
+  cmake_parse_arguments(ASSET "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+  if (NOT ASSET_SOURCE)
+    message(FATAL_ERROR "Raw asset FILE is required!")
+  endif()
+
+  if (NOT ASSET_BASE)
+    message(FATAL_ERROR "Base asset BASE is required!")
+  endif()
+
+  find_program(
+    CHR_PATCHER
+    chr-patcher
+    PATHS "${CMAKE_SOURCE_DIR}/tools"
+  )
+  if (NOT CHR_PATCHER)
+    message(FATAL_ERROR "The chr-patcher tool is required!")
+  endif()
+
+  find_program(
+    DONUT_TOOL
+    donut
+    PATHS "${CMAKE_SOURCE_DIR}/tools/${CMAKE_HOST_SYSTEM_NAME}"
+  )
+  if (NOT DONUT_TOOL)
+    message(FATAL_ERROR "The donut tool is required!")
+  endif()
+
+  set(ASSET_SRC "${CMAKE_SOURCE_DIR}/assets/${ASSET_SOURCE}")
+  set(ASSET_BASE_SRC "${CMAKE_SOURCE_DIR}/assets/${ASSET_BASE}")
+  set(ASSET_BASE_DONUT "${CMAKE_BINARY_DIR}/assets/${ASSET_BASE}.donut")
+  set(ASSET_DEST "${CMAKE_BINARY_DIR}/assets/${ASSET_SOURCE}.patch")
+
+  get_filename_component(BASE_NAME ${ASSET_DEST} NAME)
+
+  add_custom_command(
+    OUTPUT ${ASSET_DEST}
+    COMMAND ${CHR_PATCHER} patch ${ASSET_DEST} ${ASSET_SRC} --base ${ASSET_BASE_SRC} --base-donut ${ASSET_BASE_DONUT} --donut ${DONUT_TOOL}
+    DEPENDS ${CHR_PATCHER} ${DONUT_TOOL} ${ASSET_SRC} ${ASSET_BASE_SRC} ${ASSET_BASE_DONUT}
+  )
+  add_custom_target(${BASE_NAME} DEPENDS ${ASSET_DEST})
+endfunction()
+
+# Packs SOURCE (+ ALT, concatenated) with whichever codec (raw, rle, donut,
+# zx02) best fits POLICY, writing <SOURCE>.packed and a <SOURCE>.codec
+# manifest entry for add_asset_manifest. NAME is the asset's symbol name.
+# ALT is packed along with SOURCE instead of as a delta against it: our Alt
+# nametables are the other screen of each stage, not a variant of it (the
+# packer prints what a delta would cost).
+function(add_packed_asset)
+  set(options)
+  set(oneValueArgs SOURCE ALT NAME POLICY MAX_CYCLES)
+  set(multiValueArgs CODECS)
+  cmake_parse_arguments(ASSET "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+  if (NOT ASSET_SOURCE)
+    message(FATAL_ERROR "Raw asset FILE is required!")
+  endif()
+
+  if (NOT ASSET_NAME)
+    message(FATAL_ERROR "Asset NAME is required!")
+  endif()
+
+  find_program(
+    ASSET_PACKER
+    asset-packer
+    PATHS "${CMAKE_SOURCE_DIR}/tools"
+  )
+  if (NOT ASSET_PACKER)
+    message(FATAL_ERROR "The asset-packer tool is required!")
+  endif()
+
+  find_program(
+    DONUT_TOOL
+    donut
+    PATHS "${CMAKE_SOURCE_DIR}/tools/${CMAKE_HOST_SYSTEM_NAME}"
+  )
+  if (NOT DONUT_TOOL)
+    message(FATAL_ERROR "The donut tool is required!")
+  endif()
+
+  find_program(
+    ZX02_TOOL
+    zx02
+    PATHS "${CMAKE_SOURCE_DIR}/tools/${CMAKE_HOST_SYSTEM_NAME}"
+  )
+  if (NOT ZX02_TOOL)
+    message(FATAL_ERROR "The zx02 tool is required!")
+  endif()
+
+  if (NOT ASSET_POLICY)
+    set(ASSET_POLICY ${ASSET_CODEC_POLICY})
+  endif()
+
+  if (NOT ASSET_MAX_CYCLES)
+    set(ASSET_MAX_CYCLES ${ASSET_CODEC_MAX_CYCLES})
+  endif()
+
+  if (NOT ASSET_CODECS)
+    set(ASSET_CODECS raw rle donut zx02)
+  endif()
+
+  set(PACKER_ARGS --name ${ASSET_NAME} --policy ${ASSET_POLICY} --codecs ${ASSET_CODECS})
+  if (ASSET_POLICY STREQUAL "within")
+    list(APPEND PACKER_ARGS --max-cycles ${ASSET_MAX_CYCLES})
+  endif()
+
+  if (ZX02_DECODER STREQUAL "SPEED")
+    list(APPEND PACKER_ARGS --zx02-decoder speed)
+  else()
+    list(APPEND PACKER_ARGS --zx02-decoder size)
+  endif()
+
+  set(ASSET_SRC "${CMAKE_SOURCE_DIR}/assets/${ASSET_SOURCE}")
+
+  if (ASSET_ALT)
+    set(ASSET_ALT_SRC "${CMAKE_SOURCE_DIR}/assets/${ASSET_ALT}")
+  endif()
+
+  set(ASSET_DEST "${CMAKE_BINARY_DIR}/assets/${ASSET_SOURCE}.packed")
+  set(ASSET_MANIFEST "${CMAKE_BINARY_DIR}/assets/${ASSET_SOURCE}.codec")
+
+  get_filename_component(BASE_NAME ${ASSET_DEST} NAME)
+
+  add_custom_command(
+    OUTPUT ${ASSET_DEST} ${ASSET_MANIFEST}
+    COMMAND ${ASSET_PACKER} pack ${ASSET_DEST} ${ASSET_SRC} ${ASSET_ALT_SRC} --manifest ${ASSET_MANIFEST} --donut ${DONUT_TOOL} --zx02 ${ZX02_TOOL} ${PACKER_ARGS}
+    DEPENDS ${ASSET_PACKER} ${DONUT_TOOL} ${ZX02_TOOL} ${ASSET_SRC} ${ASSET_ALT_SRC}
+  )
+  add_custom_target(${BASE_NAME} DEPENDS ${ASSET_DEST} ${ASSET_MANIFEST})
+endfunction()
+
+# Generates TARGET, a header telling which codec each packed asset (listed in
+# ASSETS by their SOURCE) ended up with
+function(add_asset_manifest)
+  set(options)
+  set(oneValueArgs TARGET)
+  set(multiValueArgs ASSETS)
+  cmake_parse_arguments(MANIFEST "${options}" "${oneValueArgs}" "${multiValueArgs}" ${ARGN})
+
+  if (NOT MANIFEST_TARGET)
+    message(FATAL_ERROR "Manifest TARGET is required!")
+  endif()
+
+  find_program(
+    ASSET_PACKER
+    asset-packer
+    PATHS "${CMAKE_SOURCE_DIR}/tools"
+  )
+  if (NOT ASSET_PACKER)
+    message(FATAL_ERROR "The asset-packer tool is required!")
+  endif()
+
+  set(MANIFEST_DEST "${CMAKE_CURRENT_BINARY_DIR}/${MANIFEST_TARGET}")
+
+  set(MANIFEST_ENTRIES)
+  foreach(ASSET ${MANIFEST_ASSETS})
+    list(APPEND MANIFEST_ENTRIES "${CMAKE_BINARY_DIR}/assets/${ASSET}.codec")
+  endforeach()
+
+  add_custom_command(
+    OUTPUT ${MANIFEST_DEST}
+    COMMAND ${ASSET_PACKER} manifest ${MANIFEST_DEST} ${MANIFEST_ENTRIES}
+    DEPENDS ${ASSET_PACKER} ${MANIFEST_ENTRIES}
+  )
+endfunction()
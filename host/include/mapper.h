@@ -0,0 +1,10 @@
+#pragma once
+
+// Host stand-in for llvm-mos' mapper.h: there's a single flat address
+// space, so bank switching only remembers the bank for get_prg_bank
+
+extern "C" {
+void set_prg_bank(char bank_id);
+char get_prg_bank(void);
+void set_chr_bank(char bank_id);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Host stand-in for llvm-mos' nesdoug.h; see host/src/nesdoug.cpp
+
+extern "C" {
+void set_vram_buffer(void);
+void one_vram_buffer(char data, int ppu_address);
+void multi_vram_buffer_horz(const void *data, char len, int ppu_address);
+void multi_vram_buffer_vert(const void *data, char len, int ppu_address);
+char get_pad_new(char pad);
+char get_frame_count(void);
+char check_collision(void *object1, void *object2);
+void pal_fade_to(char from, char to);
+void set_scroll_x(unsigned x);
+void set_scroll_y(unsigned y);
+int add_scroll_y(char add, unsigned scroll);
+int sub_scroll_y(char sub, unsigned scroll);
+int get_ppu_addr(char nt, char x, char y);
+int get_at_addr(char nt, char x, char y);
+void set_data_pointer(const void *data);
+void set_mt_pointer(const void *metatiles);
+void buffer_1_mt(int ppu_address, char metatile);
+void buffer_4_mt(int ppu_address, char index);
+void flush_vram_update2(void);
+void color_emphasis(char color);
+void xy_split(unsigned x, unsigned y);
+void gray_line(void);
+void seed_rng(void);
+void clear_vram_buffer(void);
+}
+#define COL_EMP_BLUE 0x80
+#define COL_EMP_GREEN 0x40
+#define COL_EMP_RED 0x20
+#define COL_EMP_NORMAL 0x00
+#define COL_EMP_DARK 0xe0
@@ -0,0 +1,87 @@
+#pragma once
+
+// Host stand-in for llvm-mos' neslib.h; see host/src/neslib.cpp for what
+// each function does off the NES (mostly nothing)
+
+extern "C" {
+void pal_all(const void *data);
+void pal_bg(const void *data);
+void pal_spr(const void *data);
+void pal_col(char index, char color);
+void pal_clear(void);
+void pal_bright(char bright);
+void pal_spr_bright(char bright);
+void pal_bg_bright(char bright);
+void ppu_wait_nmi(void);
+void ppu_wait_frame(void);
+void ppu_off(void);
+void ppu_on_all(void);
+void ppu_on_bg(void);
+void ppu_on_spr(void);
+void ppu_mask(char mask);
+char ppu_system(void);
+char get_ppu_ctrl_var(void);
+void set_ppu_ctrl_var(char var);
+void oam_clear(void);
+void oam_size(char size);
+void oam_spr(char x, char y, char chrnum, char attr);
+void oam_meta_spr(char x, char y, const void *data);
+void oam_hide_rest(void);
+void oam_set(char index);
+char oam_get(void);
+char pad_poll(char pad);
+char pad_trigger(char pad);
+char pad_state(char pad);
+void scroll(unsigned x, unsigned y);
+void split(unsigned x);
+void bank_spr(char n);
+void bank_bg(char n);
+char rand8(void);
+unsigned rand16(void);
+void set_rand(unsigned seed);
+void set_vram_update(const void *buf);
+void flush_vram_update(const void *buf);
+void vram_adr(unsigned adr);
+void vram_put(char n);
+void vram_fill(char n, unsigned len);
+void vram_inc(char n);
+void vram_read(void *dst, unsigned size);
+void vram_write(const void *src, unsigned size);
+void vram_unrle(const void *data);
+void delay(char frames);
+}
+#define PAD_A 0x80
+#define PAD_B 0x40
+#define PAD_SELECT 0x20
+#define PAD_START 0x10
+#define PAD_UP 0x08
+#define PAD_DOWN 0x04
+#define PAD_LEFT 0x02
+#define PAD_RIGHT 0x01
+#define OAM_FLIP_V 0x80
+#define OAM_FLIP_H 0x40
+#define OAM_BEHIND 0x20
+#define MAX(x1, x2) ((x1) < (x2) ? (x2) : (x1))
+#define MIN(x1, x2) ((x1) < (x2) ? (x1) : (x2))
+#define MASK_SPR 0x10
+#define MASK_BG 0x08
+#define MASK_EDGE_SPR 0x04
+#define MASK_EDGE_BG 0x02
+#define MASK_TINT_RED 0x20
+#define MASK_TINT_BLUE 0x40
+#define MASK_TINT_GREEN 0x80
+#define MASK_MONO 0x01
+#define NAMETABLE_A 0x2000
+#define NAMETABLE_B 0x2400
+#define NAMETABLE_C 0x2800
+#define NAMETABLE_D 0x2c00
+#define NT_UPD_HORZ 0x40
+#define NT_UPD_VERT 0x80
+#define NT_UPD_EOF 0xff
+#define NTADR_A(x, y) (NAMETABLE_A | (((y) << 5) | (x)))
+#define NTADR_B(x, y) (NAMETABLE_B | (((y) << 5) | (x)))
+#define NTADR_C(x, y) (NAMETABLE_C | (((y) << 5) | (x)))
+#define NTADR_D(x, y) (NAMETABLE_D | (((y) << 5) | (x)))
+#define MSB(x) (((x) >> 8))
+#define LSB(x) (((x) & 0xff))
+extern "C" volatile char FRAME_CNT1;
@@ -0,0 +1,27 @@
+#pragma once
+
+// Host stand-in for llvm-mos' peekpoke.h: there's no memory-mapped I/O, so
+// reads and writes go to whichever handlers a driver installs (e.g. one
+// speaking the headless protocol from docs/headless.md); without them,
+// reads give 0 and writes are dropped
+
+#include <cstdint>
+
+using PeekHandler = uint8_t (*)(uint16_t address);
+using PokeHandler = void (*)(uint16_t address, uint8_t value);
+
+extern PeekHandler peek_handler;
+extern PokeHandler poke_handler;
+
+inline uint8_t host_peek(uint16_t address) {
+  return peek_handler ? peek_handler(address) : 0;
+}
+
+inline void host_poke(uint16_t address, uint8_t value) {
+  if (poke_handler) {
+    poke_handler(address, value);
+  }
+}
+
+#define PEEK(addr) host_peek((uint16_t)(addr))
+#define POKE(addr, val) host_poke((uint16_t)(addr), (uint8_t)(val))
@@ -0,0 +1,121 @@
+# The miroh-logic static library: the game logic plus stand-ins for
+# neslib, nesdoug and the mapper. Expects MIROH_ROOT (the repository root);
+# MIROH_SOA_STAND_IN adds the soa.h stand-in, for compilers other than
+# llvm-mos.
+
+set(MIROH_SRC "${MIROH_ROOT}/src")
+set(MIROH_HOST "${MIROH_ROOT}/host")
+
+list(APPEND CMAKE_MODULE_PATH "${MIROH_ROOT}/cmake")
+find_package(Ruby REQUIRED)
+
+foreach(TOOL polyomino mazer animator soundtrack-enums generate-metasprites)
+  string(TOUPPER "${TOOL}_TOOL" TOOL_VAR)
+  string(REPLACE "-" "_" TOOL_VAR "${TOOL_VAR}")
+  find_program(${TOOL_VAR} ${TOOL} PATHS "${MIROH_ROOT}/tools" NO_DEFAULT_PATH)
+  if (NOT ${TOOL_VAR})
+    message(FATAL_ERROR "The ${TOOL} tool is required!")
+  endif()
+endforeach()
+
+# same data as the ROM build, as C++ instead of assembly where needed
+
+set(GENERATED "${CMAKE_CURRENT_BINARY_DIR}/generated")
+file(MAKE_DIRECTORY "${GENERATED}")
+
+add_custom_command(
+  OUTPUT "${GENERATED}/polyominos.cpp"
+  COMMAND ${POLYOMINO_TOOL} host_data "${GENERATED}/polyominos.cpp" "${MIROH_ROOT}/assets/polyominos.json"
+  DEPENDS ${POLYOMINO_TOOL} "${MIROH_ROOT}/assets/polyominos.json"
+)
+
+add_custom_command(
+  OUTPUT "${GENERATED}/polyominos-metasprites.cpp" "${GENERATED}/polyominos-metasprites.hpp"
+  COMMAND ${POLYOMINO_TOOL} sprites "${GENERATED}/polyominos-metasprites.cpp" "${GENERATED}/polyominos-metasprites.hpp" "${MIROH_ROOT}/assets/polyominos.json" --main_bank 7 --alt_bank 8 --shadow_banks 9,10,11,12,12
+  DEPENDS ${POLYOMINO_TOOL} "${MIROH_ROOT}/assets/polyominos.json"
+)
+
+add_custom_command(
+  OUTPUT "${GENERATED}/maze-defs.cpp"
+  COMMAND ${MAZER_TOOL} host "${GENERATED}/maze-defs.cpp" "${MIROH_ROOT}/assets/mazes"
+  DEPENDS ${MAZER_TOOL} "${MIROH_ROOT}/assets/mazes"
+)
+
+add_custom_command(
+  OUTPUT "${GENERATED}/animation-defs.cpp" "${GENERATED}/animation-defs.hpp"
+  COMMAND ${ANIMATOR_TOOL} animate "${MIROH_ROOT}/assets/animations.yaml" --cpp-output "${GENERATED}/animation-defs.cpp" --hpp-output "${GENERATED}/animation-defs.hpp"
+  DEPENDS ${ANIMATOR_TOOL} "${MIROH_ROOT}/assets/animations.yaml"
+)
+
+add_custom_command(
+  OUTPUT "${GENERATED}/soundtrack.hpp"
+  COMMAND ${SOUNDTRACK_ENUMS_TOOL} generate "${GENERATED}/soundtrack.hpp" "${MIROH_ROOT}/music/soundtrack.txt"
+  DEPENDS ${SOUNDTRACK_ENUMS_TOOL} "${MIROH_ROOT}/music/soundtrack.txt"
+)
+
+add_custom_command(
+  OUTPUT "${GENERATED}/metasprites.cpp" "${GENERATED}/metasprites.hpp"
+  COMMAND ${GENERATE_METASPRITES_TOOL} generate "${GENERATED}/metasprites.cpp" "${GENERATED}/metasprites.hpp" "${MIROH_ROOT}/assets/metasprites.nss" --bank 6 --namespace Metasprites
+  DEPENDS ${GENERATE_METASPRITES_TOOL} "${MIROH_ROOT}/assets/metasprites.nss"
+)
+
+add_library(miroh-logic
+  STATIC
+
+  ${MIROH_SRC}/animation.cpp
+  ${MIROH_SRC}/automino.cpp
+  ${MIROH_SRC}/board.cpp
+  ${MIROH_SRC}/board-animation.cpp
+  ${MIROH_SRC}/cheats.cpp
+  ${MIROH_SRC}/fruits.cpp
+  ${MIROH_SRC}/gameplay.cpp
+  ${MIROH_SRC}/mountain-tiles.cpp
+  ${MIROH_SRC}/movie.cpp
+  ${MIROH_SRC}/polyomino.cpp
+  ${MIROH_SRC}/polyomino-defs.cpp
+  ${MIROH_SRC}/rng.cpp
+  ${MIROH_SRC}/unicorn.cpp
+  ${MIROH_SRC}/utils.cpp
+
+  ${MIROH_HOST}/src/game.cpp
+  ${MIROH_HOST}/src/mapper.cpp
+  ${MIROH_HOST}/src/nesdoug.cpp
+  ${MIROH_HOST}/src/neslib.cpp
+  ${MIROH_HOST}/src/peekpoke.cpp
+
+  ${GENERATED}/animation-defs.cpp
+  ${GENERATED}/maze-defs.cpp
+  ${GENERATED}/metasprites.cpp
+  ${GENERATED}/polyominos.cpp
+  ${GENERATED}/polyominos-metasprites.cpp
+  ${GENERATED}/soundtrack.hpp
+)
+
+# the stand-ins must shadow any real neslib headers around
+target_include_directories(
+  miroh-logic
+  BEFORE
+  PUBLIC
+  ${MIROH_HOST}/include
+  ${MIROH_SRC}
+  ${GENERATED}
+)
+
+# llvm-mos targets have the real soa.h
+if (MIROH_SOA_STAND_IN)
+  target_include_directories(miroh-logic BEFORE PUBLIC ${MIROH_HOST}/soa)
+endif()
+
+# NDEBUG drops the Mesen debug ports, which only exist in the emulator;
+# HEADLESS drops sound and rendering from gameplay, which reads its inputs
+# and reports its results through the ports in docs/headless.md; the
+# #pragma clang section lines place code in banks, meaningless here; GCC
+# takes the label addresses TASK_YIELD saves for dangling pointers
+target_compile_definitions(miroh-logic PUBLIC NDEBUG HEADLESS)
+target_compile_options(
+  miroh-logic
+  PRIVATE
+  -Wall -Wextra
+  $<$<CXX_COMPILER_ID:GNU>:-Wno-unknown-pragmas -Wno-dangling-pointer>
+  $<$<CXX_COMPILER_ID:Clang>:-Wno-unknown-pragmas -Wno-pragma-clang-attribute>
+)
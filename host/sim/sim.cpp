@@ -0,0 +1,495 @@
+#include "common.hpp"
+#include "gameplay.hpp"
+#include "movie.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <peekpoke.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Batch simulator: plays complete gameplay runs of each stage and game mode
+// with scripted inputs, spread over every core, and prints statistics per
+// stage, mode and level. Runs speak the headless protocol of
+// docs/headless.md, just like tools/headless.lua does in Mesen: the movie
+// goes in through $4028 and the results come out of $4029.
+//
+// The game logic keeps its state in globals, as on the NES, so workers are
+// processes rather than threads; idle workers take the next run from a
+// counter they share, so a few long runs don't hold the others back.
+
+namespace {
+  constexpr const char *STAGE_NAMES[] = {
+      "starlit-stables", "rainbow-retreat", "fairy-forest", "glittery-grotto",
+      "marshmallow-mountain"};
+  constexpr const char *MODE_NAMES[] = {"story", "endless", "time-trial"};
+  constexpr u8 NUM_MODES = 3;
+  constexpr u8 MAX_LEVEL = 20;
+  constexpr u8 RESULT_SIZE = 12;
+
+  enum class Input : u8 { Idle, Random, Automino, Movie };
+
+  struct Options {
+    u32 runs = 100;
+    u32 jobs = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = 1;
+    u16 max_steps = 36000;
+    Input input = Input::Random;
+    std::vector<u8> movie;
+    std::vector<u8> stages;
+    std::vector<u8> modes;
+    const char *levels_csv = nullptr;
+    const char *runs_csv = nullptr;
+  };
+
+  struct Job {
+    u8 stage;
+    u8 mode;
+    uint64_t seed;
+  };
+
+  struct Result {
+    u8 bytes[RESULT_SIZE];
+    bool cleared;
+    bool done;
+
+    u8 stage() const { return bytes[0]; }
+    u8 mode() const { return bytes[1]; }
+    u8 level() const { return bytes[3]; }
+    u16 score() const {
+      u16 score = 0;
+      for (u8 i = 4; i < 6; i++) {
+        score = (u16)(score * 100 + (bytes[i] >> 4) * 10 + (bytes[i] & 0x0f));
+      }
+      return score;
+    }
+    u16 steps() const { return (u16)(bytes[7] << 8 | bytes[8]); }
+    u16 lines() const { return (u16)(bytes[9] << 8 | bytes[10]); }
+    bool overflowed() const { return bytes[11] != 0; }
+  };
+
+  // lives in memory shared by all workers, followed by the results
+  struct Batch {
+    std::atomic<u32> next_job;
+
+    Result *results() { return reinterpret_cast<Result *>(this + 1); }
+  };
+
+  static_assert(std::atomic<u32>::is_always_lock_free);
+
+  uint64_t splitmix64(uint64_t &state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  // the movie fed to the current run, generated as it's read
+  struct Feed {
+    const Options *options;
+    uint64_t rng;
+    u8 header[6];
+    u8 header_position;
+    size_t movie_position;
+    u32 frames_fed;
+    u8 run[3];
+    u8 run_position;
+    Result *result;
+    u8 result_position;
+  } feed;
+
+  void next_run() {
+    const Options &options = *feed.options;
+    u8 frames = 0;
+    u8 pad = 0;
+    if (feed.frames_fed < options.max_steps) {
+      switch (options.input) {
+      case Input::Idle:
+      case Input::Automino:
+        frames = 255;
+        break;
+      case Input::Random: {
+        // mostly the polyomino's buttons, sometimes a swap to the unicorn;
+        // never start, which would just pause
+        uint64_t random = splitmix64(feed.rng);
+        static constexpr u8 BUTTONS[] = {PAD_LEFT, PAD_RIGHT, PAD_DOWN,
+                                         PAD_UP,   PAD_A,     PAD_B};
+        frames = (u8)(1 + (random & 0x0f));
+        for (u8 i = 0; i < sizeof(BUTTONS); i++) {
+          if (((random >> (8 + i * 3)) & 0b111) == 0) {
+            pad |= BUTTONS[i];
+          }
+        }
+        if (((random >> 32) & 0x3f) == 0) {
+          pad |= PAD_SELECT;
+        }
+      } break;
+      case Input::Movie:
+        // recorded movies start after the stage's intro, which the
+        // headless game skips, so their first run lines up with the first
+        // step
+        if (feed.movie_position + 3 <= options.movie.size()) {
+          frames = options.movie[feed.movie_position];
+          pad = options.movie[feed.movie_position + 1];
+          feed.movie_position += 3;
+        }
+        break;
+      }
+    }
+    feed.frames_fed += frames;
+    feed.run[0] = frames;
+    feed.run[1] = pad;
+    feed.run[2] = 0;
+    feed.run_position = 0;
+  }
+
+  u8 peek(u16 address) {
+    if (address != 0x4028) {
+      return 0;
+    }
+    if (feed.header_position < sizeof(feed.header)) {
+      return feed.header[feed.header_position++];
+    }
+    if (feed.run_position == sizeof(feed.run)) {
+      next_run();
+    }
+    return feed.run[feed.run_position++];
+  }
+
+  void poke(u16 address, u8 value) {
+    if (address == 0x4029 && feed.result_position < RESULT_SIZE) {
+      feed.result->bytes[feed.result_position++] = value;
+    }
+  }
+
+  void play(const Options &options, const Job &job, Result &result) {
+    uint64_t seed_state = job.seed;
+    // any seed goes, Rng::seed takes care of 0
+    u16 game_seed = (u16)splitmix64(seed_state);
+
+    feed = {};
+    feed.options = &options;
+    feed.rng = splitmix64(seed_state);
+    feed.header[0] = job.stage;
+    feed.header[1] = job.mode;
+    feed.header[2] = (u8)ControllerScheme::OnePlayer;
+    // the polyomino plays by itself, while the unicorn stands still; a
+    // movie keeps the cheats it was recorded with
+    if (options.input == Input::Movie &&
+        options.movie.size() >= sizeof(feed.header)) {
+      feed.header[3] = options.movie[3];
+    } else if (options.input == Input::Automino) {
+      feed.header[3] = Movie::CHEAT_AUTOMINO;
+    }
+    feed.header[4] = (u8)(game_seed >> 8);
+    feed.header[5] = (u8)game_seed;
+    // a movie's runs start after its own header
+    feed.movie_position = sizeof(feed.header);
+    feed.run_position = sizeof(feed.run);
+    feed.result = &result;
+
+    for (u8 i = 0; i < NUM_STAGES; i++) {
+      story_completion[i] = false;
+    }
+    current_game_state = GameState::Gameplay;
+    Movie::start();
+    {
+      Gameplay gameplay;
+      gameplay.loop();
+    }
+    Movie::stop();
+
+    result.cleared = story_completion[job.stage];
+    result.done = feed.result_position == RESULT_SIZE;
+  }
+
+  void work(const Options &options, const std::vector<Job> &jobs,
+            Batch &batch) {
+    peek_handler = peek;
+    poke_handler = poke;
+    while (true) {
+      u32 index = batch.next_job.fetch_add(1);
+      if (index >= jobs.size()) {
+        return;
+      }
+      play(options, jobs[index], batch.results()[index]);
+    }
+  }
+
+  template <typename T> double median(std::vector<T> values) {
+    if (values.empty()) {
+      return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle]
+                             : (values[middle - 1] + values[middle]) / 2.0;
+  }
+
+  template <typename T> double mean(const std::vector<T> &values) {
+    if (values.empty()) {
+      return 0;
+    }
+    double total = 0;
+    for (T value : values) {
+      total += value;
+    }
+    return total / (double)values.size();
+  }
+
+  void summarize(const Options &options, const Result *results, u32 count) {
+    FILE *levels =
+        options.levels_csv ? fopen(options.levels_csv, "w") : nullptr;
+    if (options.levels_csv && !levels) {
+      perror(options.levels_csv);
+      exit(1);
+    }
+    if (levels) {
+      fprintf(levels, "stage,mode,level,runs,overflows,overflow_rate\n");
+    }
+
+    printf("stage,mode,runs,lines_mean,lines_p50,score_mean,score_p50,"
+           "frames_mean,frames_p50,overflow_rate,clear_rate\n");
+    for (u8 stage : options.stages) {
+      for (u8 mode : options.modes) {
+        std::vector<u16> lines, scores, frames;
+        u32 overflows = 0, clears = 0;
+        u32 level_runs[MAX_LEVEL + 1] = {};
+        u32 level_overflows[MAX_LEVEL + 1] = {};
+        for (u32 i = 0; i < count; i++) {
+          const Result &result = results[i];
+          if (!result.done || result.stage() != stage ||
+              result.mode() != mode) {
+            continue;
+          }
+          lines.push_back(result.lines());
+          scores.push_back(result.score());
+          frames.push_back(result.steps());
+          overflows += result.overflowed();
+          clears += result.cleared;
+          u8 level = std::min(result.level(), MAX_LEVEL);
+          level_runs[level]++;
+          level_overflows[level] += result.overflowed();
+        }
+        if (lines.empty()) {
+          continue;
+        }
+        double runs = (double)lines.size();
+        printf("%s,%s,%zu,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f\n",
+               STAGE_NAMES[stage], MODE_NAMES[mode], lines.size(),
+               mean(lines), median(lines), mean(scores), median(scores),
+               mean(frames), median(frames), overflows / runs,
+               clears / runs);
+        if (!levels) {
+          continue;
+        }
+        for (u8 level = 1; level <= MAX_LEVEL; level++) {
+          if (level_runs[level] == 0) {
+            continue;
+          }
+          fprintf(levels, "%s,%s,%u,%u,%u,%.3f\n", STAGE_NAMES[stage],
+                  MODE_NAMES[mode], level, level_runs[level],
+                  level_overflows[level],
+                  level_overflows[level] / (double)level_runs[level]);
+        }
+      }
+    }
+    if (levels) {
+      fclose(levels);
+    }
+  }
+
+  void write_runs(const Options &options, const std::vector<Job> &jobs,
+                  const Result *results) {
+    FILE *file = fopen(options.runs_csv, "w");
+    if (!file) {
+      perror(options.runs_csv);
+      exit(1);
+    }
+    fprintf(file, "stage,mode,seed,gameplay_state,level,score,goal_counter,"
+                  "frames,lines,overflowed,cleared\n");
+    for (u32 i = 0; i < jobs.size(); i++) {
+      const Result &result = results[i];
+      if (!result.done) {
+        continue;
+      }
+      fprintf(file, "%s,%s,%llu,%u,%u,%u,%u,%u,%u,%u,%u\n",
+              STAGE_NAMES[jobs[i].stage], MODE_NAMES[jobs[i].mode],
+              (unsigned long long)jobs[i].seed, result.bytes[2],
+              result.level(), result.score(), result.bytes[6],
+              result.steps(), result.lines(), result.overflowed(),
+              result.cleared);
+    }
+    fclose(file);
+  }
+
+  [[noreturn]] void usage(const char *program) {
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --runs N          runs per stage and mode (default 100)\n"
+            "  --jobs N          worker processes (default: one per core)\n"
+            "  --seed N          seed the runs' seeds come from (default 1)\n"
+            "  --stages A,B...   stage numbers, from 0 (default: all)\n"
+            "  --modes A,B...    story, endless, time-trial (default: all)\n"
+            "  --input KIND      idle, random, automino or a movie file\n"
+            "                    (default random); a movie plays its pad 0\n"
+            "                    runs, from the first frame after the intro\n"
+            "  --max-frames N    frames of input per run (default 36000)\n"
+            "  --levels FILE     write overflow rates per level as CSV\n"
+            "  --runs-csv FILE   write every run's results as CSV\n",
+            program);
+    exit(2);
+  }
+
+  std::vector<std::string> split(const char *list) {
+    std::vector<std::string> items;
+    std::string item;
+    for (const char *c = list;; c++) {
+      if (*c == ',' || *c == '\0') {
+        items.push_back(item);
+        item.clear();
+        if (*c == '\0') {
+          return items;
+        }
+      } else {
+        item += *c;
+      }
+    }
+  }
+
+  Options parse_options(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+      std::string option = argv[i];
+      if (i + 1 >= argc) {
+        usage(argv[0]);
+      }
+      const char *value = argv[++i];
+      if (option == "--runs") {
+        options.runs = (u32)strtoul(value, nullptr, 0);
+      } else if (option == "--jobs") {
+        options.jobs = std::max(1u, (u32)strtoul(value, nullptr, 0));
+      } else if (option == "--seed") {
+        options.seed = strtoull(value, nullptr, 0);
+      } else if (option == "--max-frames") {
+        options.max_steps =
+            (u16)std::min(strtoul(value, nullptr, 0), 0xff00ul);
+      } else if (option == "--stages") {
+        for (const std::string &stage : split(value)) {
+          u8 number = (u8)strtoul(stage.c_str(), nullptr, 0);
+          if (number >= NUM_STAGES) {
+            usage(argv[0]);
+          }
+          options.stages.push_back(number);
+        }
+      } else if (option == "--modes") {
+        for (const std::string &mode : split(value)) {
+          const char *const *name =
+              std::find_if(std::begin(MODE_NAMES), std::end(MODE_NAMES),
+                           [&mode](const char *name) { return mode == name; });
+          if (name == std::end(MODE_NAMES)) {
+            usage(argv[0]);
+          }
+          options.modes.push_back((u8)(name - std::begin(MODE_NAMES)));
+        }
+      } else if (option == "--input") {
+        if (strcmp(value, "idle") == 0) {
+          options.input = Input::Idle;
+        } else if (strcmp(value, "random") == 0) {
+          options.input = Input::Random;
+        } else if (strcmp(value, "automino") == 0) {
+          options.input = Input::Automino;
+        } else {
+          FILE *file = fopen(value, "rb");
+          if (!file) {
+            perror(value);
+            exit(1);
+          }
+          int byte;
+          while ((byte = fgetc(file)) != EOF) {
+            options.movie.push_back((u8)byte);
+          }
+          fclose(file);
+          options.input = Input::Movie;
+        }
+      } else if (option == "--levels") {
+        options.levels_csv = value;
+      } else if (option == "--runs-csv") {
+        options.runs_csv = value;
+      } else {
+        usage(argv[0]);
+      }
+    }
+    if (options.stages.empty()) {
+      for (u8 stage = 0; stage < NUM_STAGES; stage++) {
+        options.stages.push_back(stage);
+      }
+    }
+    if (options.modes.empty()) {
+      for (u8 mode = 0; mode < NUM_MODES; mode++) {
+        options.modes.push_back(mode);
+      }
+    }
+    return options;
+  }
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options = parse_options(argc, argv);
+
+  std::vector<Job> jobs;
+  uint64_t seed_state = options.seed;
+  for (u8 stage : options.stages) {
+    for (u8 mode : options.modes) {
+      for (u32 run = 0; run < options.runs; run++) {
+        jobs.push_back({stage, mode, splitmix64(seed_state)});
+      }
+    }
+  }
+
+  size_t size = sizeof(Batch) + jobs.size() * sizeof(Result);
+  void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  Batch *batch = new (memory) Batch{};
+
+  u32 workers = std::min<u32>(options.jobs, (u32)jobs.size());
+  for (u32 i = 0; i < workers; i++) {
+    pid_t pid = fork();
+    if (pid < 0) {
+      perror("fork");
+      return 1;
+    }
+    if (pid == 0) {
+      work(options, jobs, *batch);
+      _exit(0);
+    }
+  }
+  int failed = 0;
+  for (u32 i = 0; i < workers; i++) {
+    int status;
+    wait(&status);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      failed++;
+    }
+  }
+  if (failed) {
+    fprintf(stderr, "%d workers failed; their runs are left out\n", failed);
+  }
+
+  summarize(options, batch->results(), (u32)jobs.size());
+  if (options.runs_csv) {
+    write_runs(options, jobs, batch->results());
+  }
+  return failed ? 1 : 0;
+}
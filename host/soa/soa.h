@@ -0,0 +1,120 @@
+#pragma once
+
+// Host stand-in for llvm-mos' soa.h: a plain array of structs whose
+// elements are reached through the same kind of proxies, so code written
+// for the real structure-of-arrays compiles unchanged.
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+namespace soa {
+
+template <typename T> class Ref {
+  T &value;
+
+public:
+  constexpr Ref(T &value) : value(value) {}
+  constexpr Ref(const Ref &other) = default;
+
+  constexpr T &get() const { return value; }
+  constexpr operator T &() const { return value; }
+
+  constexpr auto operator->() const {
+    if constexpr (std::is_pointer_v<std::remove_cv_t<T>>) {
+      return value;
+    } else {
+      return &value;
+    }
+  }
+
+  template <typename U> constexpr const Ref &operator=(U &&other) const {
+    value = static_cast<U &&>(other);
+    return *this;
+  }
+  constexpr const Ref &operator=(const Ref &other) const {
+    value = other.value;
+    return *this;
+  }
+
+  template <typename U> constexpr const Ref &operator+=(U other) const {
+    value += other;
+    return *this;
+  }
+  template <typename U> constexpr const Ref &operator-=(U other) const {
+    value -= other;
+    return *this;
+  }
+  template <typename U> constexpr const Ref &operator|=(U other) const {
+    value |= other;
+    return *this;
+  }
+  template <typename U> constexpr const Ref &operator&=(U other) const {
+    value &= other;
+    return *this;
+  }
+  template <typename U> constexpr const Ref &operator^=(U other) const {
+    value ^= other;
+    return *this;
+  }
+  template <typename U> constexpr const Ref &operator<<=(U other) const {
+    value <<= other;
+    return *this;
+  }
+  template <typename U> constexpr const Ref &operator>>=(U other) const {
+    value >>= other;
+    return *this;
+  }
+
+  constexpr T &operator++() const { return ++value; }
+  constexpr T &operator--() const { return --value; }
+  constexpr T operator++(int) const { return value++; }
+  constexpr T operator--(int) const { return value--; }
+};
+
+template <typename T, std::size_t N> class Array {
+  std::remove_const_t<T> data[N];
+
+  template <typename R, typename P> class Iterator {
+    P ptr;
+
+  public:
+    constexpr Iterator(P ptr) : ptr(ptr) {}
+    constexpr R operator*() const { return R(*ptr); }
+    constexpr Iterator &operator++() {
+      ++ptr;
+      return *this;
+    }
+    constexpr bool operator!=(const Iterator &other) const {
+      return ptr != other.ptr;
+    }
+  };
+
+public:
+  constexpr Array() : data() {}
+  constexpr Array(std::initializer_list<std::remove_const_t<T>> values)
+      : data() {
+    std::size_t i = 0;
+    for (const auto &value : values) {
+      data[i++] = value;
+    }
+  }
+
+  constexpr Ref<T> operator[](std::size_t i) { return Ref<T>(data[i]); }
+  constexpr Ref<const T> operator[](std::size_t i) const {
+    return Ref<const T>(data[i]);
+  }
+
+  constexpr std::size_t size() const { return N; }
+
+  constexpr auto begin() { return Iterator<Ref<T>, T *>(data); }
+  constexpr auto end() { return Iterator<Ref<T>, T *>(data + N); }
+  constexpr auto begin() const {
+    return Iterator<Ref<const T>, const T *>(data);
+  }
+  constexpr auto end() const {
+    return Iterator<Ref<const T>, const T *>(data + N);
+  }
+};
+
+} // namespace soa
@@ -0,0 +1,80 @@
+#include "bank-helper.hpp"
+#include "banked-asset-helpers.hpp"
+#include "board.hpp"
+#include "cheats.hpp"
+#include "common.hpp"
+#include "energy-sprites.hpp"
+#include "metasprites.hpp"
+
+// What the game logic needs from main.cpp and the assembly sources, minus
+// anything that only makes sense on the NES
+
+GameState current_game_state;
+GameMode current_game_mode;
+ControllerScheme current_controller_scheme;
+Stage current_stage;
+
+SelectReminder select_reminder;
+
+Board board;
+
+Cheats cheats;
+
+u16 high_score[NUM_STAGES];
+bool story_completion[NUM_STAGES];
+bool ending_triggered;
+
+// same culling as banked-asset-helpers.s: sprites whose 16-bit coordinate
+// falls out of 0..255 are hidden
+extern "C" void banked_oam_meta_spr(char, char x, int y, const void *data) {
+  const Sprite *sprite = (const Sprite *)data;
+  u8 index = (u8)SPRID;
+  for (; sprite->terminator != 0x80; sprite++) {
+    OAM_BUF[index + 3] = (char)(x + sprite->spr.x);
+    int sprite_y = y + sprite->spr.y;
+    if (sprite_y < 0 || sprite_y > 0xff) {
+      OAM_BUF[index] = (char)0xff;
+      continue;
+    }
+    OAM_BUF[index] = (char)sprite_y;
+    OAM_BUF[index + 1] = (char)sprite->spr.tile;
+    OAM_BUF[index + 2] = (char)sprite->spr.attribute;
+    index += 4;
+  }
+  SPRID = (char)index;
+}
+
+extern "C" void banked_oam_meta_spr_horizontal(int x, char y,
+                                               const void *data) {
+  const Sprite *sprite = (const Sprite *)data;
+  u8 index = (u8)SPRID;
+  for (; sprite->terminator != 0x80; sprite++) {
+    int sprite_x = x + sprite->spr.x;
+    OAM_BUF[index + 3] = (char)sprite_x;
+    if (sprite_x < 0 || sprite_x > 0xff) {
+      continue;
+    }
+    OAM_BUF[index] = (char)(y + sprite->spr.y);
+    OAM_BUF[index + 1] = (char)sprite->spr.tile;
+    OAM_BUF[index + 2] = (char)sprite->spr.attribute;
+    index += 4;
+  }
+  SPRID = (char)index;
+}
+
+// energy-sprites.s
+const soa::Array<const Sprite *, 13> energy_sprites = {
+    nullptr,
+    Metasprites::Energy1,
+    Metasprites::Energy2,
+    Metasprites::Energy3,
+    Metasprites::Energy4,
+    Metasprites::Energy5,
+    Metasprites::Energy6,
+    Metasprites::Energy7,
+    Metasprites::Energy8,
+    Metasprites::Energy9,
+    Metasprites::Energy10,
+    Metasprites::Energy11,
+    Metasprites::Energy12,
+};
@@ -0,0 +1,7 @@
+#include <mapper.h>
+
+static char prg_bank;
+
+void set_prg_bank(char bank_id) { prg_bank = bank_id; }
+char get_prg_bank(void) { return prg_bank; }
+void set_chr_bank(char) {}
@@ -0,0 +1,74 @@
+#include <nesdoug.h>
+
+#include "common.hpp"
+
+// The VRAM buffer is filled just like nesdoug does, so code writing to
+// VRAM_BUF directly and code going through these functions still agree;
+// nothing ever reads it back into a nametable, though.
+
+u8 VRAM_INDEX;
+char VRAM_BUF[256];
+
+static u8 frame_count;
+
+static void terminate_vram_buffer() { VRAM_BUF[VRAM_INDEX] = (char)0xff; }
+
+void set_vram_buffer(void) { clear_vram_buffer(); }
+
+void clear_vram_buffer(void) {
+  VRAM_INDEX = 0;
+  terminate_vram_buffer();
+}
+
+void one_vram_buffer(char data, int ppu_address) {
+  VRAM_BUF[VRAM_INDEX] = (char)(ppu_address >> 8);
+  VRAM_BUF[VRAM_INDEX + 1] = (char)ppu_address;
+  VRAM_BUF[VRAM_INDEX + 2] = data;
+  VRAM_INDEX += 3;
+  terminate_vram_buffer();
+}
+
+static void multi_vram_buffer(const void *data, char len, int ppu_address,
+                              u8 direction) {
+  const char *bytes = (const char *)data;
+  VRAM_BUF[VRAM_INDEX] = (char)((ppu_address >> 8) | direction);
+  VRAM_BUF[VRAM_INDEX + 1] = (char)ppu_address;
+  VRAM_BUF[VRAM_INDEX + 2] = len;
+  VRAM_INDEX += 3;
+  for (u8 i = 0; i < (u8)len; i++) {
+    VRAM_BUF[VRAM_INDEX++] = bytes[i];
+  }
+  terminate_vram_buffer();
+}
+
+void multi_vram_buffer_horz(const void *data, char len, int ppu_address) {
+  multi_vram_buffer(data, len, ppu_address, 0x40);
+}
+
+void multi_vram_buffer_vert(const void *data, char len, int ppu_address) {
+  multi_vram_buffer(data, len, ppu_address, 0x80);
+}
+
+char get_pad_new(char) { return 0; }
+char get_frame_count(void) { return (char)frame_count++; }
+char check_collision(void *, void *) { return 0; }
+void pal_fade_to(char, char) {}
+void set_scroll_x(unsigned) {}
+void set_scroll_y(unsigned) {}
+int add_scroll_y(char add, unsigned scroll) { return (int)(scroll + (u8)add); }
+int sub_scroll_y(char sub, unsigned scroll) { return (int)(scroll - (u8)sub); }
+int get_ppu_addr(char nt, char x, char y) {
+  return (0x2000 + (nt << 10)) | (((u8)y & 0xf8) << 2) | ((u8)x >> 3);
+}
+int get_at_addr(char nt, char x, char y) {
+  return (0x23c0 + (nt << 10)) | (((u8)y & 0xe0) >> 2) | ((u8)x >> 5);
+}
+void set_data_pointer(const void *) {}
+void set_mt_pointer(const void *) {}
+void buffer_1_mt(int, char) {}
+void buffer_4_mt(int, char) {}
+void flush_vram_update2(void) { clear_vram_buffer(); }
+void color_emphasis(char) {}
+void xy_split(unsigned, unsigned) {}
+void gray_line(void) {}
+void seed_rng(void) {}
@@ -0,0 +1,113 @@
+#include <neslib.h>
+#include <string.h>
+
+// Rendering, palettes and the PPU don't exist on the host, so those calls
+// do nothing; OAM and the random number generator behave like neslib's, so
+// game logic sees the same sprites and the same random sequence.
+
+extern "C" {
+char OAM_BUF[256];
+char SPRID;
+volatile char FRAME_CNT1;
+}
+
+static unsigned char rand_seed[2] = {0xfd, 0xfd};
+
+void pal_all(const void *) {}
+void pal_bg(const void *) {}
+void pal_spr(const void *) {}
+void pal_col(char, char) {}
+void pal_clear(void) {}
+void pal_bright(char) {}
+void pal_spr_bright(char) {}
+void pal_bg_bright(char) {}
+
+void ppu_wait_nmi(void) { FRAME_CNT1 = (char)(FRAME_CNT1 + 1); }
+void ppu_wait_frame(void) { FRAME_CNT1 = (char)(FRAME_CNT1 + 1); }
+void ppu_off(void) {}
+void ppu_on_all(void) {}
+void ppu_on_bg(void) {}
+void ppu_on_spr(void) {}
+void ppu_mask(char) {}
+char ppu_system(void) { return 0; }
+char get_ppu_ctrl_var(void) { return 0; }
+void set_ppu_ctrl_var(char) {}
+
+void oam_clear(void) { memset(OAM_BUF, 0xff, sizeof(OAM_BUF)); }
+void oam_size(char) {}
+
+void oam_spr(char x, char y, char chrnum, char attr) {
+  unsigned char index = (unsigned char)SPRID;
+  OAM_BUF[index] = y;
+  OAM_BUF[index + 1] = chrnum;
+  OAM_BUF[index + 2] = attr;
+  OAM_BUF[index + 3] = x;
+  SPRID = (char)(index + 4);
+}
+
+// metasprites are (x, y, tile, attribute) runs ended by 0x80
+void oam_meta_spr(char x, char y, const void *data) {
+  const signed char *sprite = (const signed char *)data;
+  while ((unsigned char)sprite[0] != 0x80) {
+    oam_spr((char)(x + sprite[0]), (char)(y + sprite[1]), sprite[2],
+            sprite[3]);
+    sprite += 4;
+  }
+}
+
+void oam_hide_rest(void) {
+  for (unsigned index = (unsigned char)SPRID; index < 256; index += 4) {
+    OAM_BUF[index] = (char)0xff;
+  }
+}
+void oam_set(char index) { SPRID = (char)(index & 0xfc); }
+char oam_get(void) { return SPRID; }
+
+char pad_poll(char) { return 0; }
+char pad_trigger(char) { return 0; }
+char pad_state(char) { return 0; }
+
+void scroll(unsigned, unsigned) {}
+void split(unsigned) {}
+void bank_spr(char) {}
+void bank_bg(char) {}
+
+// same two 8-bit Galois LFSRs as neslib, added together with the carry
+// out of the second one
+static unsigned char rand_step(unsigned char &seed, unsigned char taps,
+                               bool &carry) {
+  carry = seed & 0x80;
+  seed = (unsigned char)(seed << 1);
+  if (carry) {
+    seed ^= taps;
+  }
+  return seed;
+}
+
+char rand8(void) {
+  bool carry;
+  unsigned char a = rand_step(rand_seed[0], 0xcf, carry);
+  unsigned char b = rand_step(rand_seed[1], 0xd7, carry);
+  return (char)(a + b + (carry ? 1 : 0));
+}
+
+unsigned rand16(void) {
+  unsigned char hi = (unsigned char)rand8();
+  return (unsigned)(hi << 8) | (unsigned char)rand8();
+}
+
+void set_rand(unsigned seed) {
+  rand_seed[0] = (unsigned char)seed;
+  rand_seed[1] = (unsigned char)(seed >> 8);
+}
+
+void set_vram_update(const void *) {}
+void flush_vram_update(const void *) {}
+void vram_adr(unsigned) {}
+void vram_put(char) {}
+void vram_fill(char, unsigned) {}
+void vram_inc(char) {}
+void vram_read(void *dst, unsigned size) { memset(dst, 0, size); }
+void vram_write(const void *, unsigned) {}
+void vram_unrle(const void *) {}
+void delay(char) {}
@@ -0,0 +1,4 @@
+#include <peekpoke.h>
+
+PeekHandler peek_handler;
+PokeHandler poke_handler;
@@ -26,13 +26,12 @@ static constexpr u8 PREVIEW_BASE_TILE = 0x70;
 
 extern "C" const soa::Array<char *, NUM_STAGES> level_bg_palettes;
 extern "C" const soa::Array<char *, NUM_STAGES> level_spr_palettes;
-extern "C" const soa::Array<char *, NUM_STAGES> level_bg_tiles;
+extern "C" const soa::Array<char *, NUM_STAGES> level_bg_tile_patches;
 extern "C" const soa::Array<char *, NUM_STAGES> level_nametables;
-extern "C" const u8 level_bg_tile_blocks[NUM_STAGES];
 
 extern "C" const char title_bg_palette[];
 extern "C" const char title_spr_palette[];
-extern "C" const char title_bg_tiles[];
+extern "C" const char title_bg_tile_patch[];
 extern "C" const char title_nametable[];
 
 // map
@@ -43,9 +42,11 @@ extern "C" const char intro_text_nametable[];
 // ending [bank 2]
 extern "C" const char ending_text_nametable[];
 
-// base tiles, other tiles are replacement suffixes of this one
-// except for Fairy Forest, which is actually the same one
+// base tiles; the tile sets above are tools/chr-patcher patches over it,
+// made of runs of donut blocks either taken from here or stored in the patch
 extern "C" const char base_bg_tiles[];
+static constexpr u8 CHR_PATCH_FROM_BASE = 0x80;
+static constexpr u8 CHR_PATCH_END = 0xff;
 
 extern "C" const char spr_tiles[];
 
@@ -1,25 +1,17 @@
     .section .prg_rom_1,"aR",@progbits
 
-    .global level_bg_tiles
-level_bg_tiles:
-    .byte StarlitStablesBG_chr@mos16lo
-    .byte RainbowRetreatBG_chr@mos16lo
-    .byte FairyForestBG_chr@mos16lo
-    .byte GlitteryGrottoBG_chr@mos16lo
-    .byte MarshmallowMountainBG_chr@mos16lo
-    .byte StarlitStablesBG_chr@mos16hi
-    .byte RainbowRetreatBG_chr@mos16hi
-    .byte FairyForestBG_chr@mos16hi
-    .byte GlitteryGrottoBG_chr@mos16hi
-    .byte MarshmallowMountainBG_chr@mos16hi
-
-    .global level_bg_tile_blocks
-level_bg_tile_blocks:
-    .byte 41
-    .byte 37
-    .byte 0
-    .byte 37
-    .byte 41
+    .global level_bg_tile_patches
+level_bg_tile_patches:
+    .byte StarlitStablesBG_patch@mos16lo
+    .byte RainbowRetreatBG_patch@mos16lo
+    .byte FairyForestBG_patch@mos16lo
+    .byte GlitteryGrottoBG_patch@mos16lo
+    .byte MarshmallowMountainBG_patch@mos16lo
+    .byte StarlitStablesBG_patch@mos16hi
+    .byte RainbowRetreatBG_patch@mos16hi
+    .byte FairyForestBG_patch@mos16hi
+    .byte GlitteryGrottoBG_patch@mos16hi
+    .byte MarshmallowMountainBG_patch@mos16hi
 
     .global level_nametables
 level_nametables:
@@ -34,29 +26,30 @@ level_nametables:
     .byte GlitteryGrotto_nam@mos16hi
     .byte MarshmallowMountain_nam@mos16hi
 
-StarlitStablesBG_chr: .incbin "StarlitStablesBG.suffix.chr.donut"
-StarlitStables_nam: .incbin "StarlitStables.nam.zx02"
+StarlitStablesBG_patch: .incbin "StarlitStablesBG.chr.patch"
+StarlitStables_nam: .incbin "StarlitStables.nam.packed"
 
-RainbowRetreatBG_chr: .incbin "RainbowRetreatBG.suffix.chr.donut"
-RainbowRetreat_nam: .incbin "RainbowRetreat.nam.zx02"
+RainbowRetreatBG_patch: .incbin "RainbowRetreatBG.chr.patch"
+RainbowRetreat_nam: .incbin "RainbowRetreat.nam.packed"
 
 FairyForestBG_chr: .incbin "FairyForestBG.chr.donut"
-FairyForest_nam: .incbin "FairyForest.nam.zx02"
+FairyForestBG_patch: .incbin "FairyForestBG.chr.patch"
+FairyForest_nam: .incbin "FairyForest.nam.packed"
 
-GlitteryGrottoBG_chr: .incbin "GlitteryGrottoBG.suffix.chr.donut"
-GlitteryGrotto_nam: .incbin "GlitteryGrotto.nam.zx02"
+GlitteryGrottoBG_patch: .incbin "GlitteryGrottoBG.chr.patch"
+GlitteryGrotto_nam: .incbin "GlitteryGrotto.nam.packed"
 
-MarshmallowMountainBG_chr: ;.incbin "MarshmallowMountainBG.suffix.chr.donut"
-MarshmallowMountain_nam: ;.incbin "MarshmallowMountain.nam.zx02"
+MarshmallowMountainBG_patch: ;.incbin "MarshmallowMountainBG.chr.patch"
+MarshmallowMountain_nam: ;.incbin "MarshmallowMountain.nam.packed"
 
-.global title_bg_tiles, title_nametable
+.global title_bg_tile_patch, title_nametable
 
-title_bg_tiles: .incbin "TitleBG.suffix.chr.donut"
-title_nametable: .incbin "Title.nam.zx02"
+title_bg_tile_patch: .incbin "TitleBG.chr.patch"
+title_nametable: .incbin "Title.nam.packed"
 
 .global map_nametable
 
-map_nametable: .incbin "Map.nam.zx02"
+map_nametable: .incbin "Map.nam.packed"
 
     ; Generic
 .global base_bg_tiles
@@ -138,6 +131,6 @@ title_bg_palette: .incbin "TitleBG.pal"
 title_spr_palette: .incbin "TitleSPR.pal"
 
 .global intro_text_nametable
-intro_text_nametable: .incbin "IntroText.nam.zx02"
+intro_text_nametable: .incbin "IntroText.nam.packed"
 .global ending_text_nametable
-ending_text_nametable: .incbin "EndingText.nam.zx02"
+ending_text_nametable: .incbin "EndingText.nam.packed"
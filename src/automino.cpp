@@ -0,0 +1,219 @@
+#include "automino.hpp"
+#include "board.hpp"
+#include "common.hpp"
+#include "log.hpp"
+#include "polyomino-defs.hpp"
+#include "polyomino.hpp"
+#include <neslib.h>
+
+#pragma clang section text = ".prg_rom_14.text.automino"
+#pragma clang section rodata = ".prg_rom_14.rodata.automino"
+
+void Automino::think(const Polyomino &polyomino, u8 drop_frames,
+                     u16 budget) {
+  if (state == State::Waiting &&
+      polyomino.state == Polyomino::State::Inactive) {
+    this->drop_frames = drop_frames;
+    start(polyomino);
+  }
+  if (state != State::Searching) {
+    return;
+  }
+
+  // the first step always runs, as with the board's tasks
+  do {
+    if (!search_step()) {
+      state = State::Planned;
+      return;
+    }
+    budget = budget > STEP_CYCLES ? budget - STEP_CYCLES : 0;
+  } while (budget >= STEP_CYCLES);
+}
+
+void Automino::start(const Polyomino &polyomino) {
+  state = State::Searching;
+  spawned = false;
+  search.reset();
+  search.piece = polyomino.next;
+
+  // with no better plan, it drops where it spawns
+  best_score = WORST_SCORE;
+  target = polyomino.next;
+  target_column = Polyomino::SPAWN_COLUMN;
+
+  spawn_row = -(s8)(polyomino.next->bottom_limit + 1);
+}
+
+void Automino::advance(u8 frames) {
+  // the same count as Polyomino::update's drop_timer, which starts at 0
+  // when the polyomino spawns
+  for (u8 i = 0; i < frames; i++) {
+    if (++search.drop_timer > drop_frames) {
+      search.drop_timer = 0;
+      search.passing_row++;
+    }
+  }
+}
+
+bool Automino::fits(s8 column) const {
+  return (s8)(search.piece->left_limit + column) >= 0 &&
+         (s8)(search.piece->right_limit + column) < WIDTH;
+}
+
+s8 Automino::landing_row(s8 column) const {
+  const PolyominoDef *piece = search.piece;
+  s8 row = HEIGHT;
+  for (u8 i = 0; i < piece->size; i++) {
+    auto delta = piece->deltas[i];
+    s8 block_row =
+        surface[(u8)(column + delta.delta_column)] - 1 - delta.delta_row;
+    if (block_row < row) {
+      row = block_row;
+    }
+  }
+  return row;
+}
+
+s16 Automino::score(s8 row, s8 column) const {
+  const PolyominoDef *piece = search.piece;
+  if ((s8)(row + piece->top_limit) < 0) {
+    // it wouldn't fit on the board: marshmallow overflow
+    return WORST_SCORE;
+  }
+
+  // plus a spare, empty row under the piece, for the cells below it
+  u16 piece_rows[6] = {0, 0, 0, 0, 0, 0};
+  for (u8 i = 0; i < piece->size; i++) {
+    auto delta = piece->deltas[i];
+    piece_rows[(u8)delta.delta_row] |=
+        Board::OCCUPIED_BITMASK[(u8)(column + delta.delta_column)];
+  }
+
+  u8 lines = 0;
+  for (u8 i = piece->top_limit; i <= piece->bottom_limit; i++) {
+    if ((board.occupied_bitset[(u8)(row + i)] | piece_rows[i]) ==
+        FULL_ROW_BITMASK) {
+      lines++;
+    }
+  }
+
+  u8 covered = 0;
+  for (u8 i = 0; i < piece->size; i++) {
+    auto delta = piece->deltas[i];
+    u8 below = (u8)(row + delta.delta_row + 1);
+    if (below < HEIGHT &&
+        !((board.occupied_bitset[below] | piece_rows[delta.delta_row + 1]) &
+          Board::OCCUPIED_BITMASK[(u8)(column + delta.delta_column)])) {
+      covered++;
+    }
+  }
+
+  s8 depth = (s8)(2 * row + piece->top_limit + piece->bottom_limit);
+  return (s16)(lines * LINE_WEIGHT + covered * COVERED_WEIGHT +
+               depth * DEPTH_WEIGHT);
+}
+
+bool Automino::search_step() {
+  auto &task = search;
+  s8 landing;
+  s16 placement_score;
+
+  TASK_BEGIN(task);
+
+  for (u8 column = 0; column < WIDTH; column++) {
+    surface[column] = HEIGHT;
+  }
+  // bottom up, so the topmost block of each column is the last one seen;
+  // a row per step, so no step does more than one pass over the columns
+  for (task.row = HEIGHT - 1; task.row >= 0; task.row--) {
+    if (board.occupied_bitset[(u8)task.row]) {
+      for (u8 column = 0; column < WIDTH; column++) {
+        if (board.occupied_bitset[(u8)task.row] &
+            Board::OCCUPIED_BITMASK[column]) {
+          surface[column] = task.row;
+        }
+      }
+    }
+    TASK_YIELD(task, true);
+  }
+
+  for (task.rotations = 0; task.rotations < 4;
+       task.rotations++, task.piece = task.piece->right_rotation) {
+    // rotating away from the spawn column would take kicks; not worth it
+    if (!fits(Polyomino::SPAWN_COLUMN)) {
+      continue;
+    }
+    // sliding right from the spawn column, then left from the one next to
+    // it, until something is in the way
+    for (task.direction = 1; task.direction >= -1; task.direction -= 2) {
+      task.column = task.direction > 0 ? Polyomino::SPAWN_COLUMN
+                                       : Polyomino::SPAWN_COLUMN - 1;
+      task.passing_row = spawn_row;
+      task.drop_timer = 0;
+      advance(task.direction > 0 ? task.rotations : task.rotations + 1);
+
+      while (fits(task.column)) {
+        START_MESEN_WATCH("aut place");
+        landing = landing_row(task.column);
+        if (task.passing_row > landing) {
+          STOP_MESEN_WATCH("aut place");
+          break;
+        }
+        placement_score = score(landing, task.column);
+        if (placement_score > best_score) {
+          best_score = placement_score;
+          target = task.piece;
+          target_column = task.column;
+        }
+        STOP_MESEN_WATCH("aut place");
+        TASK_YIELD(task, true);
+
+        task.column += task.direction;
+        advance(1);
+      }
+    }
+  }
+
+  TASK_FINISH(task, false);
+}
+
+void Automino::drive(const Polyomino &polyomino, u8 &pressed, u8 &held) {
+  // whoever would control the polyomino doesn't
+  pressed = 0;
+  held = 0;
+
+  if (polyomino.state == Polyomino::State::Inactive) {
+    if (spawned) {
+      // the planned polyomino is down (or never got planned in time)
+      state = State::Waiting;
+      spawned = false;
+    }
+    return;
+  }
+
+  if (state == State::Waiting) {
+    // it spawned before any search; it's on its own
+    return;
+  }
+  spawned = true;
+  if (state == State::Planned) {
+    state = State::Driving;
+    presses = 0;
+  }
+  if (state != State::Driving) {
+    return;
+  }
+
+  // one button a frame: rotations, moves, then a hard drop
+  if (presses++ >= MAX_PRESSES) {
+    pressed = PAD_UP;
+  } else if (polyomino.definition != target) {
+    pressed = polyomino.definition->left_rotation == target ? PAD_B : PAD_A;
+  } else if (polyomino.column < target_column) {
+    pressed = PAD_RIGHT;
+  } else if (polyomino.column > target_column) {
+    pressed = PAD_LEFT;
+  } else {
+    pressed = PAD_UP;
+  }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "board.hpp"
+#include "common.hpp"
+#include "polyomino-defs.hpp"
+#include "polyomino.hpp"
+#include "task.hpp"
+
+// Automino mode: the polyomino plays by itself. While the next piece is on
+// its way (the spawn delay), a search drops it straight down on each
+// rotation and column it can reach by sliding along the top of the board,
+// scoring each placement; once the piece spawns, its buttons are pressed
+// for it until it gets there.
+class Automino {
+  // worst case for a search step (one placement, or one row of the board's
+  // surface); bench/ fails when a step goes over it
+  static constexpr u16 STEP_CYCLES = 1000;
+
+  // a placement's score: lines it fills, cells it leaves covered (holes in
+  // the making) and how deep its top and bottom rows go
+  static constexpr s16 LINE_WEIGHT = 32;
+  static constexpr s16 COVERED_WEIGHT = -16;
+  static constexpr s16 DEPTH_WEIGHT = 2;
+  static constexpr s16 WORST_SCORE = -0x8000;
+
+  // presses before giving up on reaching the plan (something was in the
+  // way) and dropping the polyomino where it is
+  static constexpr u8 MAX_PRESSES = 16;
+
+  static constexpr u16 FULL_ROW_BITMASK = (1 << WIDTH) - 1;
+
+public:
+  static constexpr u8 BANK = Polyomino::BANK;
+
+  enum class State : u8 {
+    Waiting,   // for the polyomino to freeze
+    Searching, // placements for the next one
+    Planned,   // waiting for the next one to spawn
+    Driving,   // the polyomino to the plan
+  };
+
+  Automino() : state(State::Waiting), spawned(false) {}
+
+  // advances the search for where the next polyomino goes, within a budget
+  // of cycles; the board must hold still meanwhile, so it only runs when
+  // polyominos are allowed to spawn
+  __attribute__((noinline)) void think(const Polyomino &polyomino,
+                                       u8 drop_frames, u16 budget);
+
+  // replaces the polyomino's buttons with the ones taking it to the plan
+  __attribute__((noinline)) void drive(const Polyomino &polyomino, u8 &pressed,
+                                       u8 &held);
+
+  // bench/ times search steps on their own
+  friend struct Benchmark;
+
+private:
+  struct SearchFrame {
+    const PolyominoDef *piece; // the rotation being tried
+    u8 rotations;              // how many right rotations it takes
+    s8 row;                    // while finding the surface
+    s8 column;
+    s8 direction;    // sweeping right (1) or left (-1) from the spawn column
+    s8 passing_row;  // where the polyomino is by the time it gets to column
+    u8 drop_timer;   // frames since passing_row last went down
+  };
+
+  State state;
+  // the planned polyomino spawned while being searched or driven
+  bool spawned;
+  u8 drop_frames;
+  s8 spawn_row;
+  // each column's topmost occupied row (HEIGHT when empty)
+  s8 surface[WIDTH];
+  Task<SearchFrame> search;
+
+  s16 best_score;
+  const PolyominoDef *target;
+  s8 target_column;
+  u8 presses;
+
+  void start(const Polyomino &polyomino);
+  // returns true while there are placements left to try
+  __attribute__((noinline)) bool search_step();
+  // the frames it takes to get one column further (or rotated once)
+  void advance(u8 frames);
+  bool fits(s8 column) const;
+  // the row where the piece being tried stops, dropped straight down
+  s8 landing_row(s8 column) const;
+  s16 score(s8 row, s8 column) const;
+};
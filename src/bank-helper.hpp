@@ -1,15 +1,34 @@
 #pragma once
 
 #include "common.hpp"
+#include "log.hpp"
 #include <mapper.h>
 #include <type_traits>
 
+// With BANK_SWITCH_PROFILE, bank switching helpers take their call site as
+// extra defaulted parameters and report it to tools/log.lua
+#if defined(BANK_SWITCH_PROFILE) && !defined(NDEBUG)
+#define BANK_SWITCH_SITE_PARAMS                                                \
+  , const char *site_file = __builtin_FILE(), u16 site_line = __builtin_LINE()
+#define BANK_SWITCH_SITE_DECL , const char *site_file, u16 site_line
+#define BANK_SWITCH_SITE_ARGS , site_file, site_line
+#define LOG_BANK_SWITCH(bank) log_bank_switch(site_file, site_line, bank)
+#else
+#define BANK_SWITCH_SITE_PARAMS
+#define BANK_SWITCH_SITE_DECL
+#define BANK_SWITCH_SITE_ARGS
+#define LOG_BANK_SWITCH(bank)                                                  \
+  do {                                                                         \
+  } while (0)
+#endif
+
 class ScopedBank {
   u8 old_bank;
 
 public:
-  ScopedBank(u8 bank) {
+  ScopedBank(u8 bank BANK_SWITCH_SITE_PARAMS) {
     old_bank = get_prg_bank();
+    LOG_BANK_SWITCH(bank);
     set_prg_bank(bank);
   };
 
@@ -18,8 +37,9 @@ public:
 
 template <typename Func>
 __attribute__((noinline, section(".prg_rom_fixed.text.banked_lambda"))) auto
-banked_lambda(char bank_id, Func lambda) -> decltype(lambda()) {
-  ScopedBank bank(bank_id);
+banked_lambda(char bank_id, Func lambda BANK_SWITCH_SITE_PARAMS)
+    -> decltype(lambda()) {
+  ScopedBank bank((u8)bank_id BANK_SWITCH_SITE_ARGS);
   if constexpr (std::is_void_v<decltype(lambda())>) {
     lambda();
     return;
@@ -28,3 +48,35 @@ banked_lambda(char bank_id, Func lambda) -> decltype(lambda()) {
     return retval;
   }
 }
+
+template <u8 caller_bank, u8 target_bank, typename Func>
+__attribute__((noinline, section(".prg_rom_fixed.text.banked_lambda"))) auto
+bank_trampoline(Func lambda BANK_SWITCH_SITE_DECL) -> decltype(lambda()) {
+  LOG_BANK_SWITCH(target_bank);
+  set_prg_bank(target_bank);
+  if constexpr (std::is_void_v<decltype(lambda())>) {
+    lambda();
+    set_prg_bank(caller_bank);
+    return;
+  } else {
+    auto retval = lambda();
+    set_prg_bank(caller_bank);
+    return retval;
+  }
+}
+
+// Like banked_lambda, but for callers that know which bank they live in: a
+// call into their own bank is just a call, and other banks don't need the
+// current bank to be read and saved, since caller_bank is what's restored.
+// Code in the fixed bank can run with any bank mapped, so it must keep
+// using banked_lambda.
+template <u8 caller_bank, u8 target_bank, typename Func>
+__attribute__((always_inline)) inline auto
+banked_call(Func lambda BANK_SWITCH_SITE_PARAMS) -> decltype(lambda()) {
+  if constexpr (caller_bank == target_bank) {
+    return lambda();
+  } else {
+    return bank_trampoline<caller_bank, target_bank>(
+        lambda BANK_SWITCH_SITE_ARGS);
+  }
+}
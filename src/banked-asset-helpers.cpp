@@ -1,65 +1,104 @@
 #include "banked-asset-helpers.hpp"
+#include "asset-manifest.hpp"
 #include "assets.hpp"
 #include "bank-helper.hpp"
 #include "common.hpp"
 #include "donut.hpp"
-#include "zx02.hpp"
+#include "log.hpp"
+#include "packed-asset.hpp"
 #include <mapper.h>
 #include <neslib.h>
 
-#pragma clang section text = ".prg_rom_fixed.text.bah"
-#pragma clang section rodata = ".prg_rom_fixed.rodata.bah"
+// loading happens once per screen, so none of this takes up the fixed bank;
+// palette loaders live with the palettes, the rest with the other assets
+
+#pragma clang section text = ".prg_rom_3.text.bah"
+#pragma clang section rodata = ".prg_rom_3.rodata.bah"
 
 void load_title_palette() {
-  ScopedBank scopedBank(PALETTES_BANK);
   pal_bg(title_bg_palette);
   pal_spr(title_spr_palette);
 }
 
+void load_stage_palette() {
+  pal_bg(level_bg_palettes[(u8)current_stage]);
+  pal_spr(level_spr_palettes[(u8)current_stage]);
+}
+
+void change_uni_palette() {
+  for (u8 i = 0; i < 16; i++) {
+    pal_col(0x10 | i, level_spr_palettes[(u8)current_stage][i]);
+  }
+}
+
+#pragma clang section text = ".prg_rom_1.text.bah"
+#pragma clang section rodata = ".prg_rom_1.rodata.bah"
+
+// Marshmallow Mountain's nametable isn't packed yet (see assets.s), and the
+// world map never starts it, so only the stages before it have an entry
+static constexpr PackedAsset
+    level_nametable_assets[(u8)Stage::MarshmallowMountain] = {
+        AssetManifest::StarlitStables_nam,
+        AssetManifest::RainbowRetreat_nam,
+        AssetManifest::FairyForest_nam,
+        AssetManifest::GlitteryGrotto_nam,
+};
+
+// Uploads a tile set patched over base_bg_tiles to pattern table 0
+static void load_bg_tile_patch(const char *tile_patch) {
+  auto *patch = (const u8 *)tile_patch;
+  while (patch[0] != CHR_PATCH_END) {
+    u8 first_block = patch[0] & ~CHR_PATCH_FROM_BASE;
+    u8 block_count = patch[1];
+    vram_adr(PPU_PATTERN_TABLE_0 + first_block * 64);
+    if (patch[0] & CHR_PATCH_FROM_BASE) {
+      u16 offset = (u16)(patch[2] | (patch[3] << 8));
+      Donut::decompress_to_ppu((void *)(base_bg_tiles + offset),
+                               (char)block_count);
+      patch += 4;
+    } else {
+      patch = (const u8 *)Donut::decompress_to_ppu((void *)(patch + 2),
+                                                   (char)block_count);
+    }
+  }
+}
+
 void load_title_assets() {
-  ScopedBank scopedBank(ASSETS_BANK);
-  vram_adr(PPU_PATTERN_TABLE_0);
-  Donut::decompress_to_ppu((void *)base_bg_tiles, 4096 / 64 - 56);
-  Donut::decompress_to_ppu((void *)title_bg_tiles, 56);
+  load_bg_tile_patch(title_bg_tile_patch);
 
   vram_adr(PPU_PATTERN_TABLE_1);
   Donut::decompress_to_ppu((void *)spr_tiles, 4096 / 64);
 
   vram_adr(NAMETABLE_D);
-  zx02_decompress_to_vram((void *)title_nametable, NAMETABLE_D);
-  load_title_palette();
+  START_MESEN_WATCH("#nam title");
+  unpack_to_vram(AssetManifest::title_nametable, title_nametable, NAMETABLE_D);
+  STOP_MESEN_WATCH("#nam title");
+  banked_call<ASSETS_BANK, PALETTES_BANK>([]() { load_title_palette(); });
 }
 
 void load_map_assets() {
-  ScopedBank scopedBank(ASSETS_BANK);
   vram_adr(PPU_PATTERN_TABLE_0);
   Donut::decompress_to_ppu((void *)base_bg_tiles, 4096 / 64);
   vram_adr(PPU_PATTERN_TABLE_0 + 0xf0 * 0x10);
   Donut::decompress_to_ppu((void *)spare_characters, 3);
 
   vram_adr(NAMETABLE_A);
-  zx02_decompress_to_vram((void *)map_nametable, NAMETABLE_A);
-
-  load_title_palette();
-}
+  START_MESEN_WATCH("#nam map");
+  unpack_to_vram(AssetManifest::map_nametable, map_nametable, NAMETABLE_A);
+  STOP_MESEN_WATCH("#nam map");
 
-void load_stage_palette() {
-  ScopedBank scopedBank(PALETTES_BANK);
-  pal_bg(level_bg_palettes[(u8)current_stage]);
-  pal_spr(level_spr_palettes[(u8)current_stage]);
+  banked_call<ASSETS_BANK, PALETTES_BANK>([]() { load_title_palette(); });
 }
 
 void load_gameplay_assets() {
-  ScopedBank scopedBank(ASSETS_BANK);
-  vram_adr(PPU_PATTERN_TABLE_0);
-  u8 bg_blocks = level_bg_tile_blocks[(u8)current_stage];
-  Donut::decompress_to_ppu((void *)base_bg_tiles, 4096 / 64 - bg_blocks);
-  if (bg_blocks > 0) {
-    Donut::decompress_to_ppu(level_bg_tiles[(u8)current_stage], bg_blocks);
-  }
+  fake_assert(current_stage != Stage::MarshmallowMountain);
+  load_bg_tile_patch(level_bg_tile_patches[(u8)current_stage]);
 
   vram_adr(NAMETABLE_B);
-  zx02_decompress_to_vram(level_nametables[(u8)current_stage], NAMETABLE_B);
+  START_MESEN_WATCH("#nam level");
+  unpack_to_vram(level_nametable_assets[(u8)current_stage],
+                 level_nametables[(u8)current_stage], NAMETABLE_B);
+  STOP_MESEN_WATCH("#nam level");
 
   // mode labels start at tile $84, both require 1 donut block (64 bytes)
   if (current_game_mode == GameMode::TimeTrial) {
@@ -88,12 +127,5 @@ void load_gameplay_assets() {
     vram_write(endless_prompt[2], 20);
   }
 
-  load_stage_palette();
-}
-
-void change_uni_palette() {
-  ScopedBank scopedBank(PALETTES_BANK);
-  for (u8 i = 0; i < 16; i++) {
-    pal_col(0x10 | i, level_spr_palettes[(u8)current_stage][i]);
-  }
+  banked_call<ASSETS_BANK, PALETTES_BANK>([]() { load_stage_palette(); });
 }
@@ -6,14 +6,14 @@ extern "C" void banked_oam_meta_spr(char bank, char x, int y, const void *data);
 // draws metasprite from the metasprite bank w/ horizontal scroll culling
 extern "C" void banked_oam_meta_spr_horizontal(int x, char y, const void *data);
 
-// loads title assets
+// loads title assets; lives in ASSETS_BANK
 __attribute((noinline)) void load_title_assets();
 
-// loads map assets
+// loads map assets; lives in ASSETS_BANK
 __attribute((noinline)) void load_map_assets();
 
-// loads game assets
+// loads game assets; lives in ASSETS_BANK
 __attribute((noinline)) void load_gameplay_assets();
 
-// loads palette for uni map
+// loads palette for uni map; lives in PALETTES_BANK
 __attribute((noinline)) void change_uni_palette();
\ No newline at end of file
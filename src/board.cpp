@@ -1,9 +1,9 @@
 #include "board.hpp"
 #include "assets.hpp"
 #include "common.hpp"
-#include "coroutine.hpp"
 #include "ggsound.hpp"
 #include "maze-defs.hpp"
+#include "rng.hpp"
 #include "soundtrack.hpp"
 #include "union-find.hpp"
 #include "utils.hpp"
@@ -167,7 +167,7 @@ void Board::generate_maze() {
         random_row < HEIGHT - 1 ? &disjoint_set[index + WIDTH] : NULL;
 
     // randomize if we are looking first horizontally or vertically
-    bool down_first = rand8() & 0b1;
+    bool down_first = Rng::next() & 0b1;
 
     if (down_first && down_element &&
         current_element->representative() != down_element->representative()) {
@@ -193,16 +193,20 @@ void Board::generate_maze() {
 }
 
 void Board::reset() {
-  // make all cells free
+  // make all cells free (and forget rows of an interrupted line clearing)
   for (u8 i = 0; i < HEIGHT; i++) {
     occupied_bitset[i] = 0;
+    deleted[i] = false;
   }
 
   // reset animations
-  for (auto animation : animations) {
+  for (auto &animation : animations) {
     animation.finished = true;
   }
   active_animations = false;
+
+  line_clearing.reset();
+  tasks.reset();
 }
 
 void Board::render() {
@@ -510,9 +514,9 @@ bool Board::ongoing_line_clearing() {
   bool any_deleted = false;
   bool changed = false;
   u8 lines_cleared_for_sfx;
-  static u16 column_mask;
+  auto &task = line_clearing;
 
-  CORO_INIT;
+  TASK_BEGIN(task);
 
   for (u8 i = 0; i < HEIGHT; i++) {
     if (row_filled(i)) {
@@ -522,7 +526,7 @@ bool Board::ongoing_line_clearing() {
   }
 
   if (!any_deleted) {
-    CORO_FINISH(false);
+    TASK_FINISH(task, false);
   }
 
   lines_cleared_for_sfx = 0xff;
@@ -535,53 +539,52 @@ bool Board::ongoing_line_clearing() {
   GGSound::play_sfx(sfx_per_lines_cleared[lines_cleared_for_sfx],
                     GGSound::SFXPriority::Two);
 
-  for (erasing_row = HEIGHT - 1; erasing_row >= 0; erasing_row--) {
-    if (deleted[erasing_row]) {
-      for (erasing_column = 0; erasing_column < WIDTH; erasing_column++) {
-        set_maze_cell((u8)erasing_row, erasing_column, CellType::Maze);
-        CORO_YIELD(true);
+  for (task.row = HEIGHT - 1; task.row >= 0; task.row--) {
+    if (deleted[task.row]) {
+      for (task.column = 0; task.column < WIDTH; task.column++) {
+        set_maze_cell((u8)task.row, task.column, CellType::Maze);
+        TASK_YIELD(task, true);
       }
     }
   }
 
-  for (erasing_column = 0, column_mask = 1; erasing_column < WIDTH;
-       erasing_column++, column_mask <<= 1) {
-    erasing_row = HEIGHT - 1;
-    erasing_row_source = HEIGHT - 1;
+  for (task.column = 0, task.column_mask = 1; task.column < WIDTH;
+       task.column++, task.column_mask <<= 1) {
+    task.row = HEIGHT - 1;
+    task.row_source = HEIGHT - 1;
 
-    while (erasing_row >= 0) {
-      while (erasing_row_source >= 0 && deleted[erasing_row_source]) {
-        erasing_row_source--;
+    while (task.row >= 0) {
+      while (task.row_source >= 0 && deleted[task.row_source]) {
+        task.row_source--;
       }
 
       changed = false;
-      if (erasing_row_source < erasing_row) {
+      if (task.row_source < task.row) {
         bool source_occupied =
-            erasing_row_source < 0
+            task.row_source < 0
                 ? false
-                : occupied_bitset[(u8)erasing_row_source] & column_mask;
+                : occupied_bitset[(u8)task.row_source] & task.column_mask;
 
         if (source_occupied) {
-          if (!(occupied_bitset[(u8)erasing_row] & column_mask)) {
-            set_maze_cell((u8)erasing_row, erasing_column,
-                          CellType::Marshmallow);
+          if (!(occupied_bitset[(u8)task.row] & task.column_mask)) {
+            set_maze_cell((u8)task.row, task.column, CellType::Marshmallow);
             changed = true;
           }
-          set_maze_cell((u8)erasing_row_source, erasing_column, CellType::Maze);
+          set_maze_cell((u8)task.row_source, task.column, CellType::Maze);
           changed = true;
-        } else if (occupied_bitset[(u8)erasing_row] & column_mask) {
-          set_maze_cell((u8)erasing_row, erasing_column, CellType::Maze);
+        } else if (occupied_bitset[(u8)task.row] & task.column_mask) {
+          set_maze_cell((u8)task.row, task.column, CellType::Maze);
           changed = true;
         }
       }
-      erasing_row--;
-      erasing_row_source--;
+      task.row--;
+      task.row_source--;
 
       if (!changed) {
         continue;
       }
 
-      CORO_YIELD(true);
+      TASK_YIELD(task, true);
     }
   }
 
@@ -589,9 +592,54 @@ bool Board::ongoing_line_clearing() {
     deleted[i] = false;
   }
 
-  CORO_FINISH(false);
+  TASK_FINISH(task, false);
+}
+
+bool Board::ongoing_overflow_fill() {
+  u8 row = random_free_row();
+  if (row > HEIGHT) {
+    return false;
+  }
+  u8 column = random_free_column(row);
+  set_maze_cell(row, column, CellType::Marshmallow);
+  if ((get_frame_count() & 0b1111) == 0) {
+    GGSound::play_sfx(SFX::Blockplacement, GGSound::SFXPriority::One);
+  }
+
+  // done as soon as the last cell is filled, so the overflow can end on
+  // the next frame
+  for (u8 i = 0; i < HEIGHT; i++) {
+    if (!row_filled(i)) {
+      return true;
+    }
+  }
+  return false;
 }
 
+void Board::start_line_clearing() {
+  if (!tasks.scheduled<Board, &Board::ongoing_line_clearing>(this)) {
+    tasks.spawn<Board, &Board::ongoing_line_clearing>(
+        this, LINE_CLEARING_STEP_CYCLES);
+  }
+}
+
+bool Board::start_overflow_fill() {
+  for (u8 i = 0; i < HEIGHT; i++) {
+    if (!row_filled(i)) {
+      tasks.spawn<Board, &Board::ongoing_overflow_fill>(
+          this, OVERFLOW_FILL_STEP_CYCLES);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Board::overflow_filling() {
+  return tasks.scheduled<Board, &Board::ongoing_overflow_fill>(this);
+}
+
+bool Board::run_tasks(u16 budget) { return tasks.run(budget); }
+
 u8 Board::random_free_row() {
   u8 possible_rows[HEIGHT];
   u8 max_possible_rows = 0;
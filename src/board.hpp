@@ -3,6 +3,7 @@
 #include "board-animation.hpp"
 #include "cell.hpp"
 #include "common.hpp"
+#include "task.hpp"
 #include <soa.h>
 
 static constexpr u8 HEIGHT = 10;
@@ -12,6 +13,15 @@ class Board {
 
   static constexpr u16 FULL_ROW_BITMASK = 0x0fff;
 
+  // rough worst case for a step of ongoing_line_clearing: the filled row
+  // scan plus a couple of set_maze_cell calls (check with the "lin" watch)
+  static constexpr u16 LINE_CLEARING_STEP_CYCLES = 1500;
+
+  // rough worst case for a step of ongoing_overflow_fill: picking a random
+  // free cell (scanning every row, then a row's columns) plus a
+  // set_maze_cell call (check with the "lin" watch)
+  static constexpr u16 OVERFLOW_FILL_STEP_CYCLES = 1500;
+
 public:
   static constexpr u8 BANK = 4;
 
@@ -62,6 +72,25 @@ public:
   // returns true if such process is still ongoing
   __attribute__((noinline)) bool ongoing_line_clearing();
 
+  // fills a random free cell with marshmallow
+  // returns true while there are free cells left
+  __attribute__((noinline)) bool ongoing_overflow_fill();
+
+  // queues a line clearing (which only does anything if there are filled
+  // rows), unless one is queued already
+  __attribute__((noinline)) void start_line_clearing();
+
+  // queues filling every free cell, one per frame, to end a marshmallow
+  // overflow; returns false if there's no free cell to begin with
+  __attribute__((noinline)) bool start_overflow_fill();
+
+  // tells if the overflow fill is still going
+  __attribute__((noinline)) bool overflow_filling();
+
+  // advances queued board effects within a budget of cycles; returns true
+  // while any of them is still going
+  __attribute__((noinline)) bool run_tasks(u16 budget);
+
   // returns index of a row with free space (or 0xff in case of failure)
   __attribute__((noinline)) u8 random_free_row();
 
@@ -79,9 +108,15 @@ public:
   __attribute__((noinline)) void animate();
 
 private:
-  s8 erasing_row;
-  u8 erasing_column;
-  s8 erasing_row_source;
+  struct LineClearingFrame {
+    s8 row;
+    u8 column;
+    s8 row_source;
+    u16 column_mask;
+  };
+
+  Task<LineClearingFrame> line_clearing;
+  TaskScheduler<4> tasks;
 
   // marks a position as not occupied by a solid block
   __attribute__((section(".prg_rom_fixed.text.board"))) void free(u8 row,
@@ -7,12 +7,17 @@
 #include <neslib.h>
 #include <string.h>
 
+// cheat codes are only ever typed on the title screen
+#pragma clang section text = ".prg_rom_3.text.cheats"
+#pragma clang section rodata = ".prg_rom_3.rodata.cheats"
+
 __attribute__((used)) const SFX cheat_code_sfx[] = {
     SFX::Lineclear1, SFX::Lineclear2, SFX::Lineclear3, SFX::Lineclear4};
 
 Cheats::Cheats()
     : cheat_code{0, 0, 0, 0}, cheat_code_index(0), higher_score(false),
-      higher_level(false), infinite_energy(false), fixed_polyomino(false) {}
+      higher_level(false), infinite_energy(false), fixed_polyomino(false),
+      automino(false) {}
 
 void Cheats::push_code(u8 code) {
   GGSound::play_sfx(cheat_code_sfx[cheat_code_index],
@@ -41,6 +46,9 @@ void Cheats::push_code(u8 code) {
     } else if (memcmp(cheat_code, "glhf"_ts, 4) == 0) {
       fixed_polyomino = true;
       multi_vram_buffer_horz("glhf"_ts, 4, NTADR_D(26, 27));
+    } else if (memcmp(cheat_code, "self"_ts, 4) == 0) {
+      automino = true;
+      multi_vram_buffer_horz("self"_ts, 4, NTADR_D(2, 28));
     }
   }
 }
@@ -51,4 +59,5 @@ void Cheats::reset() {
   higher_level = false;
   infinite_energy = false;
   fixed_polyomino = false;
+  automino = false;
 }
\ No newline at end of file
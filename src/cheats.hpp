@@ -10,8 +10,10 @@ public:
   bool higher_level;
   bool infinite_energy;
   bool fixed_polyomino;
+  bool automino;
 
-  Cheats();
+  // runs before main, whatever bank is there
+  __attribute__((section(".prg_rom_fixed.text.cheats"))) Cheats();
 
   void push_code(u8 code);
   void reset();
@@ -48,7 +48,7 @@ extern Stage current_stage;
 class Board;
 extern Board board;
 extern bool story_completion[];
-extern u16 high_score[];
+extern u16 high_score[]; // packed BCD, one digit per nibble
 extern bool ending_triggered;
 extern SelectReminder select_reminder;
 
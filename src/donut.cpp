@@ -1,10 +1,14 @@
 
 #include "donut.hpp"
 
+#pragma clang section text = ".prg_rom_1.text.donut"
+
 extern "C" void _asm_donut_decompress_to_ppu(void *stream_ptr, char num_blocks);
+extern "C" void *donut_stream_ptr;
 
 namespace Donut {
-  void decompress_to_ppu(void *stream_ptr, char num_blocks) {
+  void *decompress_to_ppu(void *stream_ptr, char num_blocks) {
     _asm_donut_decompress_to_ppu(stream_ptr, num_blocks);
+    return donut_stream_ptr;
   }
 } // namespace Donut
@@ -1,7 +1,9 @@
 #pragma once
 
 namespace Donut {
-  // Decompress num_blocks * 64 bytes from stream_ptr to the PPU.
-  // Remember to turn off rendering before using.
-  void decompress_to_ppu(void *stream_ptr, char num_blocks);
+  // Decompress num_blocks * 64 bytes from stream_ptr to the PPU, returning
+  // a pointer past the last block read.
+  // Remember to turn off rendering before using; it lives in ASSETS_BANK,
+  // along with the decompressor and what's compressed.
+  void *decompress_to_ppu(void *stream_ptr, char num_blocks);
 } // namespace Donut
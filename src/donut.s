@@ -26,6 +26,7 @@
 ;;; 2022-09-13: Don't use fixed memory locations, add support for C code
 
         .global _asm_donut_decompress_to_ppu
+        .global donut_stream_ptr
         .global donut_block_buffer
         .global VRAM_BUF
         donut_block_buffer = VRAM_BUF + 0x40
@@ -194,6 +194,7 @@ void Fruits::render_fruit(u8 fruit_index, int y_scroll) {
     if ((fruit.despawn_counter & 0b111) == 0b100) {
       break;
     }
+    [[fallthrough]];
   case Fruit::State::Active:
     banked_oam_meta_spr(METASPRITES_BANK, fruit.x, fruit.y - y_scroll,
                         (fruit.bobbing_counter & 0b10000)
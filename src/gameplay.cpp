@@ -1,5 +1,6 @@
 #include "animation.hpp"
 #include "assets.hpp"
+#include "automino.hpp"
 #include "board.hpp"
 #include "cheats.hpp"
 #include "log.hpp"
@@ -7,11 +8,11 @@
 #include "mountain-tiles.hpp"
 #include "polyomino.hpp"
 #include "soundtrack.hpp"
-#ifndef NDEBUG
-#include <cstdio>
-#endif
 #include <nesdoug.h>
 #include <neslib.h>
+#ifdef HEADLESS
+#include <peekpoke.h>
+#endif
 
 #include "bank-helper.hpp"
 
@@ -22,6 +23,8 @@
 #include "fruits.hpp"
 #include "gameplay.hpp"
 #include "ggsound.hpp"
+#include "movie.hpp"
+#include "rng.hpp"
 #include "unicorn.hpp"
 
 #pragma clang section text = ".prg_rom_0.text.gameplay"
@@ -70,14 +73,15 @@ void Drops::add_random_drop() {
   if (index == drops.size()) {
     return;
   }
-  drops[index].row =
-      banked_lambda(Board::BANK, []() { return board.random_free_row(); });
+  drops[index].row = banked_call<Gameplay::BANK, Board::BANK>(
+      []() { return board.random_free_row(); });
   if (drops[index].row > HEIGHT) {
     return;
   }
-  drops[index].column = banked_lambda(Board::BANK, [this, &index]() {
-    return board.random_free_column(drops[index].row);
-  });
+  drops[index].column =
+      banked_call<Gameplay::BANK, Board::BANK>([this, &index]() {
+        return board.random_free_column(drops[index].row);
+      });
   drops[index].x = (u8)(drops[index].column << 4) + board.origin_x;
   drops[index].target_y = (u8)(drops[index].row << 4) + board.origin_y;
   drops[index].current_y = 0;
@@ -92,7 +96,7 @@ void Drops::update() {
     }
     if (drop.current_y == drop.target_y) {
       GGSound::play_sfx(SFX::Blockplacement, GGSound::SFXPriority::One);
-      banked_lambda(Board::BANK, [&drop]() {
+      banked_call<Gameplay::BANK, Board::BANK>([&drop]() {
         board.set_maze_cell(drop.row, drop.column, CellType::Marshmallow);
       });
       drop.row = 0xff;
@@ -128,42 +132,30 @@ void Drops::render(int y_scroll) {
   }
 }
 
-bool Drops::random_hard_drop() {
-  return banked_lambda(Board::BANK, []() {
-    u8 row = board.random_free_row();
-    if (row > HEIGHT) {
-      return false;
-    }
-    u8 column = board.random_free_column(row);
-    board.set_maze_cell(row, column, CellType::Marshmallow);
-    if ((get_frame_count() & 0b1111) == 0) {
-      GGSound::play_sfx(SFX::Blockplacement, GGSound::SFXPriority::One);
-    }
-    return true;
-  });
-}
-
 Gameplay::Gameplay()
     : experience(0), current_level(cheats.higher_level ? MAX_LEVEL : 1),
-      unicorn(banked_lambda(Unicorn::BANK,
-                            []() { return Unicorn(board, 80.0_fp, 80.0_fp); })),
+      unicorn(banked_call<BANK, Unicorn::BANK>(
+          []() { return Unicorn(board, 80.0_fp, 80.0_fp); })),
       polyomino(board), fruits(board), gameplay_state(GameplayState::Playing),
-      input_mode(InputMode::Polyomino), yes_no_option(false),
-      pause_option(PauseOption::Resume), drops(), y_scroll(INTRO_SCROLL_Y),
-      goal_counter(0) {
+      // in automino mode, the polyomino plays by itself
+      input_mode(cheats.automino ? InputMode::Unicorn : InputMode::Polyomino),
+      yes_no_option(false), pause_option(PauseOption::Resume), drops(),
+      y_scroll(INTRO_SCROLL_Y), goal_counter(0) {
 
   // if player wasn't reminded, reset remind state progress
   if (select_reminder != SelectReminder::Reminded) {
     select_reminder = SelectReminder::NeedToRemind;
   }
 
-  banked_lambda(Polyomino::BANK, [&]() { polyomino.init(); });
+  banked_call<BANK, Polyomino::BANK>([&]() { polyomino.init(); });
 
-  load_gameplay_assets();
+#ifndef HEADLESS
+  banked_call<BANK, ASSETS_BANK>([]() { load_gameplay_assets(); });
+#endif
 
   vram_adr(NAMETABLE_A);
 
-  banked_lambda(Board::BANK, []() {
+  banked_call<BANK, Board::BANK>([]() {
     board.reset();
     board.render();
   });
@@ -174,16 +166,23 @@ Gameplay::Gameplay()
 
   scroll(0, (unsigned int)y_scroll);
 
-  banked_lambda(Unicorn::BANK, [this]() { unicorn.refresh_score_hud(); });
+  banked_call<BANK, Unicorn::BANK>([this]() { unicorn.refresh_score_hud(); });
 
   initialize_goal();
 
+#ifdef HEADLESS
+  // the PPU stays off, and no intro is shown
+  y_scroll = DEFAULT_Y_SCROLL;
+  lines_total = 0;
+  overflowed = false;
+#else
   ppu_on_all();
 
   GGSound::play_song(song_per_stage[(u8)current_stage]);
 
   pal_fade_to(0, 4);
 
+  // the intro isn't part of the movie, so it reads the pads directly
   for (u16 waiting_frames = 0; waiting_frames < INTRO_DELAY; waiting_frames++) {
     pad_poll(0);
     pad_poll(1);
@@ -192,6 +191,7 @@ Gameplay::Gameplay()
     }
     ppu_wait_nmi();
   }
+  Movie::ignore_held_pads();
 
   while (y_scroll != Gameplay::DEFAULT_Y_SCROLL) {
     ppu_wait_nmi();
@@ -201,11 +201,14 @@ Gameplay::Gameplay()
     }
     scroll(0, (unsigned int)y_scroll);
   }
+#endif
 }
 
 Gameplay::~Gameplay() {
+#ifndef HEADLESS
   pal_fade_to(4, 0);
-  color_emphasis(COL_EMP_NORMAL);
+#endif
+  SET_COLOR_EMPHASIS(COL_EMP_NORMAL);
   ppu_off();
 }
 
@@ -223,7 +226,7 @@ void Gameplay::render_non_polyominos() {
   fruits.render_below_player(y_scroll, unicorn.y.whole + board.origin_y);
   if (gameplay_state != GameplayState::Swapping ||
       swap_frames[swap_index].display_unicorn) {
-    banked_lambda(Unicorn::BANK, [this]() { unicorn.render(y_scroll); });
+    banked_call<BANK, Unicorn::BANK>([this]() { unicorn.render(y_scroll); });
   }
   fruits.render_above_player(y_scroll, unicorn.y.whole + board.origin_y);
 }
@@ -231,13 +234,13 @@ void Gameplay::render_polyomino() {
   if (gameplay_state == GameplayState::MarshmallowOverflow &&
       overflow_state == OverflowState::FlashOutsideBlocks &&
       (marshmallow_overflow_counter & 0b1000)) {
-    banked_lambda(Polyomino::BANK,
-                  [&]() { polyomino.outside_render(y_scroll); });
+    banked_call<BANK, Polyomino::BANK>(
+        [&]() { polyomino.outside_render(y_scroll); });
   } else if ((gameplay_state == GameplayState::Swapping &&
               swap_frames[swap_index].display_polyomino) ||
              (gameplay_state != GameplayState::Swapping &&
               gameplay_state != GameplayState::MarshmallowOverflow)) {
-    banked_lambda(Polyomino::BANK, [&]() { polyomino.render(y_scroll); });
+    banked_call<BANK, Polyomino::BANK>([&]() { polyomino.render(y_scroll); });
   }
 }
 void Gameplay::render() {
@@ -259,8 +262,10 @@ void Gameplay::render() {
     drops.render(y_scroll);
   }
 
-  banked_lambda(Unicorn::BANK,
-                [this]() { unicorn.refresh_energy_hud(y_scroll); });
+  CPU_METER(Hud);
+  banked_call<BANK, Unicorn::BANK>(
+      [this]() { unicorn.refresh_energy_hud(y_scroll); });
+  CPU_METER(Render);
 
   if (SPRID) {
     // if we rendered 64 sprites already, SPRID will have wrapped around back to
@@ -269,7 +274,8 @@ void Gameplay::render() {
     oam_hide_rest();
   }
 
-  banked_lambda(Board::BANK, []() { board.animate(); });
+  CPU_METER(Board);
+  banked_call<BANK, Board::BANK>([]() { board.animate(); });
 }
 
 void Gameplay::initialize_goal() {
@@ -367,7 +373,7 @@ void Gameplay::pause_handler() {
     GGSound::play_sfx(SFX::Uiconfirm, GGSound::SFXPriority::One);
     switch (pause_option) {
     case PauseOption::Exit:
-      ppu_wait_nmi();
+      wait_vblank();
       gameplay_state = GameplayState::ConfirmExit;
       multi_vram_buffer_horz("      return to world map?      "_ts, 32,
                              PAUSE_MENU_POSITION);
@@ -381,7 +387,7 @@ void Gameplay::pause_handler() {
       GGSound::resume();
       break;
     case PauseOption::Retry:
-      ppu_wait_nmi();
+      wait_vblank();
       gameplay_state = GameplayState::ConfirmRetry;
       multi_vram_buffer_horz("       restart this stage?      "_ts, 32,
                              PAUSE_MENU_POSITION);
@@ -535,8 +541,9 @@ void Gameplay::gameplay_handler() {
     pause_game();
     return;
   } else if (any_pressed & PAD_SELECT) {
-    if (polyomino.state == Polyomino::State::Active ||
-        current_controller_scheme == ControllerScheme::TwoPlayers) {
+    if (!cheats.automino &&
+        (polyomino.state == Polyomino::State::Active ||
+         current_controller_scheme == ControllerScheme::TwoPlayers)) {
       swap_inputs();
       if (current_controller_scheme == ControllerScheme::OnePlayer) {
         select_reminder = SelectReminder::Reminded;
@@ -556,11 +563,20 @@ void Gameplay::gameplay_handler() {
   // "board upkeep" prevents players from affecting the board state;
   // polyominos won't spawn, victory conditions won't trigger, unicorn
   // won't push blocks, etc.
-  bool board_upkeep_active =
-      gameplay_state == GameplayState::MarshmallowOverflow ||
-      unicorn.state == Unicorn::State::Trapped || board.active_animations ||
-      banked_lambda(Board::BANK,
-                    []() { return board.ongoing_line_clearing(); });
+  bool board_upkeep_active;
+  if (gameplay_state == GameplayState::MarshmallowOverflow) {
+    // no line clearing while the mountain overflows, only its own tasks
+    banked_call<BANK, Board::BANK>(
+        []() { board.run_tasks(BOARD_TASKS_BUDGET); });
+    board_upkeep_active = true;
+  } else {
+    board_upkeep_active =
+        unicorn.state == Unicorn::State::Trapped || board.active_animations ||
+        banked_call<BANK, Board::BANK>([]() {
+          board.start_line_clearing();
+          return board.run_tasks(BOARD_TASKS_BUDGET);
+        });
+  }
   STOP_MESEN_WATCH("lin");
 
   START_MESEN_WATCH("pol");
@@ -570,10 +586,20 @@ void Gameplay::gameplay_handler() {
     polyomino.spawn_speed_tier = spawn_speed_tier_per_level[current_level - 1];
     bool was_inactive = polyomino.state == Polyomino::State::Inactive;
 
-    banked_lambda(Polyomino::BANK, [&]() { polyomino.spawn_update(); });
+    if (cheats.automino) {
+      START_MESEN_WATCH("aut");
+      banked_call<BANK, Automino::BANK>([this]() {
+        automino.think(polyomino, DROP_FRAMES_PER_LEVEL[current_level - 1],
+                       AUTOMINO_BUDGET);
+      });
+      STOP_MESEN_WATCH("aut");
+    }
+
+    banked_call<BANK, Polyomino::BANK>([&]() { polyomino.spawn_update(); });
 
     if (was_inactive && polyomino.state == Polyomino::State::Active &&
-        current_controller_scheme == ControllerScheme::OnePlayer) {
+        current_controller_scheme == ControllerScheme::OnePlayer &&
+        !cheats.automino) {
       if (select_reminder == SelectReminder::NeedToRemind) {
         select_reminder = SelectReminder::WaitingBlockToRemind;
       } else if (select_reminder == SelectReminder::WaitingBlockToRemind) {
@@ -583,12 +609,17 @@ void Gameplay::gameplay_handler() {
   }
   STOP_MESEN_WATCH("spn");
   START_MESEN_WATCH("inp");
-  banked_lambda(Polyomino::BANK, [&]() {
+  if (cheats.automino) {
+    banked_call<BANK, Automino::BANK>([this]() {
+      automino.drive(polyomino, polyomino_pressed, polyomino_held);
+    });
+  }
+  banked_call<BANK, Polyomino::BANK>([&]() {
     polyomino.handle_input(polyomino_pressed, polyomino_held);
   });
   STOP_MESEN_WATCH("inp");
   START_MESEN_WATCH("upd");
-  banked_lambda(Polyomino::BANK, [&]() {
+  banked_call<BANK, Polyomino::BANK>([&]() {
     polyomino.update(DROP_FRAMES_PER_LEVEL[current_level - 1],
                      blocks_were_placed, failed_to_place, lines_cleared);
   });
@@ -596,7 +627,7 @@ void Gameplay::gameplay_handler() {
   STOP_MESEN_WATCH("pol");
 
   START_MESEN_WATCH("uni");
-  banked_lambda(Unicorn::BANK, [this, board_upkeep_active]() {
+  banked_call<BANK, Unicorn::BANK>([this, board_upkeep_active]() {
     unicorn.update(unicorn_pressed, unicorn_held, board_upkeep_active);
   });
   STOP_MESEN_WATCH("uni");
@@ -606,6 +637,9 @@ void Gameplay::gameplay_handler() {
   STOP_MESEN_WATCH("fru");
   START_MESEN_WATCH("ovr");
   if (failed_to_place) {
+#ifdef HEADLESS
+    overflowed = true;
+#endif
     gameplay_state = GameplayState::MarshmallowOverflow;
     overflow_state = OverflowState::FlashOutsideBlocks;
     marshmallow_overflow_counter = 0xff;
@@ -636,6 +670,9 @@ void Gameplay::gameplay_handler() {
                                                3, 3, 3, 4, 4, 4};
     u8 points = points_per_lines[lines_cleared - 1];
     add_experience(lines_cleared);
+#ifdef HEADLESS
+    lines_total += lines_cleared;
+#endif
     for (u8 i = 0; i < multiplier_per_energy[unicorn.energy]; i++) {
       unicorn.add_score(points);
     }
@@ -682,7 +719,7 @@ void Gameplay::marshmallow_overflow_handler() {
     if (marshmallow_overflow_counter >> 2 >= 20) {
       overflow_state = OverflowState::ShadowBeforeRaining;
       marshmallow_overflow_counter = 0xff;
-      color_emphasis(COL_EMP_DARK);
+      SET_COLOR_EMPHASIS(COL_EMP_DARK);
     }
     break;
   case OverflowState::ShadowBeforeRaining:
@@ -712,7 +749,17 @@ void Gameplay::marshmallow_overflow_handler() {
   case OverflowState::DropEverywhereElse:
     if (Drops::active_drops) {
       drops.update();
-    } else if (!drops.random_hard_drop()) {
+    } else if (banked_call<BANK, Board::BANK>(
+                   []() { return board.start_overflow_fill(); })) {
+      // gameplay_handler's board tasks fill it, starting this frame
+      overflow_state = OverflowState::FillEverywhereElse;
+    } else {
+      overflow_state = OverflowState::GameOver;
+    }
+    break;
+  case OverflowState::FillEverywhereElse:
+    if (!banked_call<BANK, Board::BANK>(
+            []() { return board.overflow_filling(); })) {
       overflow_state = OverflowState::GameOver;
     }
     break;
@@ -760,10 +807,11 @@ void Gameplay::game_mode_upkeep(bool stuff_in_progress) {
       }
       break;
     case Stage::GlitteryGrotto:
-      if (unicorn.score > SCORE_GOAL) {
+      // packed BCD compares just like binary
+      if (unicorn.score_digits >= SCORE_GOAL_DIGITS) {
         points_left = 0;
       } else {
-        points_left = SCORE_GOAL - unicorn.score;
+        points_left = SCORE_GOAL - bcd_to_binary(unicorn.score_digits);
       }
     case Stage::MarshmallowMountain:
       // TODO: track Miroh Jr's defeat
@@ -777,7 +825,7 @@ void Gameplay::game_mode_upkeep(bool stuff_in_progress) {
     multi_vram_buffer_horz(goal_counter_text, 2, NTADR_A(15, 27));
 
     if (!stuff_in_progress && goal_counter == 0) {
-      ppu_wait_nmi();
+      wait_vblank();
       multi_vram_buffer_horz(
           story_mode_victory_text_per_stage[(u8)current_stage], 32,
           PAUSE_MENU_POSITION);
@@ -814,7 +862,7 @@ void Gameplay::game_mode_upkeep(bool stuff_in_progress) {
     break;
   }
   if (game_is_over()) {
-    ppu_wait_nmi();
+    wait_vblank();
     if (current_game_mode == GameMode::Story) {
       fail_game();
     } else {
@@ -843,7 +891,7 @@ void Gameplay::fail_game() {
 }
 
 void Gameplay::pause_game() {
-  ppu_wait_nmi();
+  wait_vblank();
   gameplay_state = GameplayState::Paused;
   GGSound::pause();
   multi_vram_buffer_horz("             paused             "_ts, 32,
@@ -873,30 +921,97 @@ void Gameplay::swap_inputs() {
   swap_index = 0;
 }
 
+void Gameplay::wait_vblank() {
+#ifndef HEADLESS
+  ppu_wait_nmi();
+  waited_frames++;
+#endif
+}
+
+bool Gameplay::logic_step() {
+  switch (gameplay_state) {
+  case GameplayState::MarshmallowOverflow:
+    Gameplay::marshmallow_overflow_handler();
+    [[fallthrough]];
+  case GameplayState::Playing:
+    Gameplay::gameplay_handler();
+    break;
+  case GameplayState::Paused:
+    Gameplay::pause_handler();
+    break;
+  case GameplayState::ConfirmExit:
+    Gameplay::confirm_exit_handler();
+    break;
+  case GameplayState::ConfirmRetry:
+    Gameplay::confirm_retry_handler();
+    break;
+  case GameplayState::ConfirmContinue:
+    Gameplay::confirm_continue_handler();
+    break;
+  case GameplayState::RetryOrExit:
+    Gameplay::retry_exit_handler();
+    break;
+  case GameplayState::Retrying:
+    // leaves the gameplay loop; since we're still on the gameplay game
+    // state this is equivalent to retrying under the same conditions
+    return false;
+  case GameplayState::Swapping:
+    swap_frame_counter++;
+    if (swap_frame_counter >= swap_frames[swap_index].duration) {
+      swap_frame_counter = 0;
+      swap_index++;
+      if (swap_index >= sizeof(swap_frames) / sizeof(swap_frames[0])) {
+        swap_index = 0;
+        gameplay_state = GameplayState::Playing;
+      }
+    }
+    break;
+  }
+  return true;
+}
+
 void Gameplay::loop() {
+#ifdef HEADLESS
+  u16 steps = 0;
+#else
   bool no_lag_frame = true;
+  // logic overran into the next frame, not counting frames it waited for
+  bool lagged = false;
   extern volatile char FRAME_CNT1;
+#endif
 
   while (current_game_state == GameState::Gameplay) {
+#ifdef HEADLESS
+    // steps as fast as it can, until the run's movie ends or the game does;
+    // nothing is shown, so the VRAM buffer is just dropped
+    clear_vram_buffer();
+    if (Movie::finished() ||
+        gameplay_state == GameplayState::ConfirmContinue ||
+        gameplay_state == GameplayState::RetryOrExit) {
+      break;
+    }
+    steps++;
+#else
     ppu_wait_nmi();
+#endif
 
     START_MESEN_WATCH("all");
     START_MESEN_WATCH("hndl");
-    pad_poll(0);
-    pad_poll(1);
+    CPU_METER(Logic);
+    Movie::poll_pads();
     if (input_mode == InputMode::Unicorn) {
-      unicorn_pressed = get_pad_new(0);
-      unicorn_held = pad_state(0);
-      polyomino_pressed = get_pad_new(1);
-      polyomino_held = pad_state(1);
+      unicorn_pressed = Movie::pad_pressed(0);
+      unicorn_held = Movie::pad_held(0);
+      polyomino_pressed = Movie::pad_pressed(1);
+      polyomino_held = Movie::pad_held(1);
       if (polyomino_pressed) {
         current_controller_scheme = ControllerScheme::TwoPlayers;
       }
     } else {
-      unicorn_pressed = get_pad_new(1);
-      unicorn_held = pad_state(1);
-      polyomino_pressed = get_pad_new(0);
-      polyomino_held = pad_state(0);
+      unicorn_pressed = Movie::pad_pressed(1);
+      unicorn_held = Movie::pad_held(1);
+      polyomino_pressed = Movie::pad_pressed(0);
+      polyomino_held = Movie::pad_held(0);
       if (unicorn_pressed) {
         current_controller_scheme = ControllerScheme::TwoPlayers;
       }
@@ -904,67 +1019,84 @@ void Gameplay::loop() {
     any_pressed = unicorn_pressed | polyomino_pressed;
     any_held = unicorn_held | polyomino_held;
 
+#ifdef HEADLESS
+    bool still_playing = logic_step();
+    STOP_MESEN_WATCH("hndl");
+    STOP_MESEN_WATCH("all");
+    if (!still_playing) {
+      break;
+    }
+#else
     u8 frame = FRAME_CNT1;
+    GameplayState frame_state = gameplay_state;
+    waited_frames = 0;
 
-    switch (gameplay_state) {
-    case GameplayState::MarshmallowOverflow:
-      Gameplay::marshmallow_overflow_handler();
-    case GameplayState::Playing:
-      Gameplay::gameplay_handler();
-      break;
-    case GameplayState::Paused:
-      Gameplay::pause_handler();
-      break;
-    case GameplayState::ConfirmExit:
-      Gameplay::confirm_exit_handler();
-      break;
-    case GameplayState::ConfirmRetry:
-      Gameplay::confirm_retry_handler();
-      break;
-    case GameplayState::ConfirmContinue:
-      Gameplay::confirm_continue_handler();
-      break;
-    case GameplayState::RetryOrExit:
-      Gameplay::retry_exit_handler();
-      break;
-    case GameplayState::Retrying:
-      // leaves the gameplay loop; since we're still on the gameplay game
-      // state this is equivalent to retrying under the same conditions
+    if (!logic_step()) {
+      CPU_METER(Idle);
       return;
-    case GameplayState::Swapping:
-      swap_frame_counter++;
-      if (swap_frame_counter >= swap_frames[swap_index].duration) {
-        swap_frame_counter = 0;
-        swap_index++;
-        if (swap_index >= sizeof(swap_frames) / sizeof(swap_frames[0])) {
-          swap_index = 0;
-          gameplay_state = GameplayState::Playing;
-        }
+    }
+#ifdef LAG_CATCH_UP
+    if (lagged) {
+      // steps once more for the frame lost to lag, so timers and drops
+      // keep up with the clock; nothing new is pressed on that frame
+      unicorn_pressed = polyomino_pressed = any_pressed = 0;
+      if (!logic_step()) {
+        CPU_METER(Idle);
+        return;
       }
-      break;
     }
+#endif
     STOP_MESEN_WATCH("hndl");
     START_MESEN_WATCH("render");
 
-    if (VRAM_INDEX + 16 < 64) {
-      banked_lambda(Unicorn::BANK, [this]() { unicorn.refresh_score_hud(); });
+    if (unicorn.score_hud_dirty && VRAM_INDEX + 16 < 64) {
+      CPU_METER(Hud);
+      banked_call<BANK, Unicorn::BANK>(
+          [this]() { unicorn.refresh_score_hud(); });
     }
 
     if (no_lag_frame) {
+      CPU_METER(Render);
       render();
-    } else {
-#ifndef NDEBUG
-      putchar('X');
-      putchar('\n');
-#endif
     }
+    // what's left of the frame goes to the next random numbers, if anything
+    // is left: not once the frame is over, nor while catching up with lag
+    if (frame == FRAME_CNT1 && !lagged) {
+      Rng::refill();
+    }
+    CPU_METER(Idle);
     STOP_MESEN_WATCH("render");
 
     STOP_MESEN_WATCH("all");
 
     no_lag_frame = frame == FRAME_CNT1;
+    lagged = (u8)(FRAME_CNT1 - frame) > waited_frames;
+    if (lagged) {
+      LOG_LAG_FRAME(GameState::Gameplay, frame_state);
+    }
+#endif
   }
+#ifdef HEADLESS
+  report_result(steps);
+#endif
+}
+
+#ifdef HEADLESS
+void Gameplay::report_result(u16 steps) {
+  POKE(0x4029, (u8)current_stage);
+  POKE(0x4029, (u8)current_game_mode);
+  POKE(0x4029, (u8)gameplay_state);
+  POKE(0x4029, current_level);
+  POKE(0x4029, (u8)(unicorn.score_digits >> 8));
+  POKE(0x4029, (u8)unicorn.score_digits);
+  POKE(0x4029, (u8)goal_counter);
+  POKE(0x4029, (u8)(steps >> 8));
+  POKE(0x4029, (u8)steps);
+  POKE(0x4029, (u8)(lines_total >> 8));
+  POKE(0x4029, (u8)lines_total);
+  POKE(0x4029, overflowed);
 }
+#endif
 
 void Gameplay::add_experience(u8 exp) {
   if (current_level < MAX_LEVEL) {
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "automino.hpp"
 #include "fruits.hpp"
 #include "polyomino.hpp"
 #include "unicorn.hpp"
+#include "utils.hpp"
 
 struct Drop {
   u8 row;
@@ -29,7 +31,6 @@ public:
   void add_random_drop();
   void update();
   void render(int y_scroll);
-  bool random_hard_drop();
 };
 
 class Gameplay {
@@ -60,6 +61,7 @@ class Gameplay {
     FewDrops,
     FasterDrops,
     DropEverywhereElse,
+    FillEverywhereElse, // a board task, see Board::start_overflow_fill
     GameOver,
   };
 
@@ -71,6 +73,15 @@ class Gameplay {
   static constexpr u8 DROP_FRAMES_PER_LEVEL[] = {
       120, 95, 74, 57, 43, 31, 23, 16, 11, 8, 5, 3, 2, 1, 1, 1, 0, 0, 0, 0};
 
+  // cycles set aside each frame for deferred board work (line clearing and
+  // such), on top of what the rest of gameplay_handler costs; extra tasks
+  // past this wait for the next frame
+  static constexpr u16 BOARD_TASKS_BUDGET = 3000;
+
+  // cycles for the automino's search each frame; it only runs while there
+  // are no board tasks, so it gets their share
+  static constexpr u16 AUTOMINO_BUDGET = BOARD_TASKS_BUDGET;
+
 public:
   static constexpr u8 BANK = 0;
   static constexpr u16 INTRO_DELAY = 900;
@@ -101,6 +112,7 @@ public:
   static constexpr u8 BLOCKS_GOAL = 3;
   static constexpr u16 SCORE_GOAL = 10;
 #endif
+  static constexpr u16 SCORE_GOAL_DIGITS = to_bcd(SCORE_GOAL);
 
   __attribute__((noinline)) Gameplay();
   __attribute__((noinline)) ~Gameplay();
@@ -112,6 +124,7 @@ private:
 
   Unicorn unicorn;
   Polyomino polyomino;
+  Automino automino;
   Fruits fruits;
 
   // sub-state for the gameplay state
@@ -166,7 +179,24 @@ private:
   bool failed_to_place;
   u8 lines_cleared;
   bool snack_was_eaten;
+  // frames the current step waited for on purpose (not lag)
+  u8 waited_frames;
+#ifdef HEADLESS
+  // reported along with the run's results
+  u16 lines_total;
+  bool overflowed;
+#endif
 
+  // runs the current gameplay state's handler once; false when leaving the
+  // gameplay loop
+  bool logic_step();
+  // waits for vblank from within a handler (e.g. before queuing a big VRAM
+  // update), without that counting as a lag frame
+  void wait_vblank();
+#ifdef HEADLESS
+  // sends how the run went to tools/headless.lua
+  void report_result(u16 steps);
+#endif
   void render_polyomino();
   void render();
   void render_non_polyominos();
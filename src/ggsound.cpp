@@ -5,6 +5,8 @@
 #pragma clang section text = ".prg_rom_fixed.text.ggsound"
 #pragma clang section rodata = ".prg_rom_fixed.rodata.ggsound"
 
+#ifndef HEADLESS
+
 extern "C" u8 sound_param_byte_0;
 extern "C" u8 sound_param_byte_1;
 extern "C" void *sound_param_word_0;
@@ -13,7 +15,20 @@ extern "C" void *sound_param_word_2;
 extern "C" void *sound_param_word_3;
 extern "C" u8 sound_bank;
 
+// drained by the engine's NMI update (sound_flush_queue); 0 means nothing
+// queued, songs and sound effects are queued as their index + 1
+extern "C" u8 sound_queue_song;
+extern "C" u8 sound_queue_pause;
+extern "C" u8 sound_queue_sfx[2];
+
 namespace GGSound {
+  // sound_queue_pause values, as in ggsound.inc
+  enum class QueuedPause : u8 {
+    None = 0,
+    Pause = 1,
+    Resume = 2,
+  };
+
   inline namespace Wrapper {
     extern "C" void sound_initialize();
     extern "C" void sound_stop();
@@ -43,28 +58,62 @@ namespace GGSound {
   }
 
   void stop() {
+    // nothing queued before stopping should play after it
+    sound_queue_song = 0;
+    sound_queue_pause = (u8)QueuedPause::None;
+    sound_queue_sfx[0] = 0;
+    sound_queue_sfx[1] = 0;
     ScopedBank ggsound_bank(BANK);
     sound_stop();
   }
-  void pause() {
-    ScopedBank ggsound_bank(BANK);
-    pause_song();
-  }
-  void resume() {
-    ScopedBank ggsound_bank(BANK);
-    resume_song();
-  }
+
+  void pause() { sound_queue_pause = (u8)QueuedPause::Pause; }
+
+  void resume() { sound_queue_pause = (u8)QueuedPause::Resume; }
 
   void play_song(Song song) {
-    sound_param_byte_0 = (u8)song;
-    ScopedBank ggsound_bank(BANK);
-    Wrapper::play_song();
+    sound_queue_song = (u8)song + 1;
+    // a new song starts unpaused anyway
+    sound_queue_pause = (u8)QueuedPause::None;
   }
 
+  // when a frame plays more than one effect on a stream, the one ranked
+  // highest here is kept (the latest one, on a tie): game events and menu
+  // choices over the clicks of pieces moving and landing
+  static constexpr u8 sfx_rank[] = {
+      1, // Rotate
+      3, // Eat
+      6, // Outofenergy
+      2, // Headbutt
+      4, // Lineclear1
+      5, // Lineclear2
+      5, // Lineclear3
+      6, // Lineclear4
+      2, // Blockhit
+      2, // Butt
+      3, // Marshmallow
+      6, // Blockoverflow
+      4, // Uiconfirm
+      2, // Uioptionscycle
+      3, // Uiabort
+      5, // Timeralmostgone
+      7, // Levelup
+      2, // Snackspawn
+      4, // Unicornon
+      4, // Unicornoff
+      1, // Blockplacement
+      1, // Number1pblockdrop
+  };
+  static_assert(sizeof(sfx_rank) == NUM_SFXS,
+                "sfx_rank needs a rank for each sound effect");
+
   void play_sfx(SFX sfx, SFXPriority priority) {
-    sound_param_byte_0 = (u8)sfx;
-    sound_param_byte_1 = (u8)priority;
-    ScopedBank ggsound_bank(BANK);
-    Wrapper::play_sfx();
+    // one effect per stream: the engine would replace it too
+    u8 &queued = sound_queue_sfx[(u8)priority - (u8)SFXPriority::One];
+    if (queued == 0 || sfx_rank[(u8)sfx] >= sfx_rank[queued - 1]) {
+      queued = (u8)sfx + 1;
+    }
   }
 } // namespace GGSound
+
+#endif
@@ -52,6 +52,20 @@ namespace GGSound {
     Two = (u8)Stream::SFX2,
   };
 
+#ifdef HEADLESS
+  // headless builds (see movie.hpp) are silent; the engine's NMI hook stays
+  // disabled, since init never runs
+  template <typename... Args> inline void init(Args...) {}
+  inline void stop() {}
+  inline void play_song(Song) {}
+  inline void play_sfx(SFX, SFXPriority) {}
+  inline void pause() {}
+  inline void resume() {}
+#else
+  // Songs, sound effects, pauses and resumes are queued, and run on the next
+  // NMI along with the engine's update, in the bank switch it makes anyway;
+  // init and stop take effect right away.
+
   // Initialize sound engine
   __attribute__((noinline)) void init(Region region, const Track *song_list[],
                                       const Track *sfx_list[],
@@ -65,15 +79,17 @@ namespace GGSound {
   // Kill all active streams and halt sound
   __attribute__((noinline)) void stop();
 
-  // Plays a song
+  // Plays a song (queued)
   __attribute__((noinline)) void play_song(Song song);
 
-  // Plays a sound effect with a given priority
+  // Plays a sound effect with a given priority (queued; per priority, the
+  // frame's highest ranked one wins, see sfx_rank)
   __attribute__((noinline)) void play_sfx(SFX sfx, SFXPriority priority);
 
-  // Pauses a song
+  // Pauses a song (queued)
   __attribute__((noinline)) void pause();
 
-  // Resumes a song
+  // Resumes a song (queued)
   __attribute__((noinline)) void resume();
+#endif
 } // namespace GGSound
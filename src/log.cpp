@@ -17,14 +17,19 @@ void put_hex(u16 h) {
   put_hex((u8)(h >> 8));
   put_hex((u8)h);
 }
-void start_mesen_watch(const char *addr) {
-  u16 address = (u16)(uintptr_t)addr;
-  POKE(0x4020, (address >> 8) & 0xFF);
-  POKE(0x4020, address & 0xFF);
+void break_mesen(u8 label) { POKE(0x4019, label); }
+#if !defined(NDEBUG) && defined(CPU_METER_ENABLED)
+char CpuMeter::Idle = COL_EMP_NORMAL;
+#endif
+void log_lag_frame(u8 game_state, u8 sub_state) {
+  POKE(0x4025, game_state);
+  POKE(0x4025, sub_state);
 }
-void stop_mesen_watch(const char *addr) {
-  u16 address = (u16)(uintptr_t)addr;
-  POKE(0x4021, (address >> 8) & 0xFF);
-  POKE(0x4021, address & 0xFF);
-}
-void break_mesen(u8 label) { POKE(0x4019, label); }
\ No newline at end of file
+void log_bank_switch(const char *file, u16 line, u8 bank) {
+  u16 address = (u16)(uintptr_t)file;
+  POKE(0x4022, (address >> 8) & 0xFF);
+  POKE(0x4022, address & 0xFF);
+  POKE(0x4023, (line >> 8) & 0xFF);
+  POKE(0x4023, line & 0xFF);
+  POKE(0x4024, bank);
+}
\ No newline at end of file
@@ -6,9 +6,14 @@ void put_hexdigit(u8 h);
 void put_hex(u8 h);
 void put_hex(u16 h);
 
-void start_mesen_watch(const char *addr);
-void stop_mesen_watch(const char *addr);
 void break_mesen(u8 label);
+// Counts a frame whose logic overran into the next one, by game state and
+// that state's own sub-state (e.g. Gameplay's gameplay_state); only
+// Gameplay::loop checks for lag, the title screen and world map don't
+void log_lag_frame(u8 game_state, u8 sub_state);
+// Reports a switch to bank from file:line; see BANK_SWITCH_PROFILE in
+// bank-helper.hpp
+void log_bank_switch(const char *file, u16 line, u8 bank);
 
 #ifdef NDEBUG
 #define START_MESEN_WATCH(addr)                                                \
@@ -20,11 +25,80 @@ void break_mesen(u8 label);
 #define BREAK_MESEN(label)                                                     \
   do {                                                                         \
   } while (0)
+#define LOG_LAG_FRAME(game_state, sub_state)                                   \
+  do {                                                                         \
+    (void)(game_state);                                                        \
+    (void)(sub_state);                                                         \
+  } while (0)
 #define fake_assert(condition) ((void)0)
+#define CPU_METER(phase)                                                       \
+  do {                                                                         \
+  } while (0)
+#define SET_COLOR_EMPHASIS(color) color_emphasis(color)
 #else
-#define START_MESEN_WATCH(addr) start_mesen_watch(addr)
-#define STOP_MESEN_WATCH(addr) stop_mesen_watch(addr)
+#include "watch-labels.hpp"
+#include <peekpoke.h>
+
+// Watch labels become their index in the WATCH_LABELS table generated by
+// tools/watch-labels, so a watch is a single port write; the build's
+// log.lua gets the same table to name them.
+// Labels starting with '#' are benchmarks: tools/log.lua logs their
+// cycle count every time they stop, even if they take more than a frame
+// (e.g. asset loading with rendering off)
+consteval u8 watch_id(const char *label) {
+  for (u16 id = 0; id < NUM_WATCH_LABELS; id++) {
+    const char *known = WATCH_LABELS[id];
+    u8 i = 0;
+    while (known[i] != '\0' && known[i] == label[i]) {
+      i++;
+    }
+    if (known[i] == label[i]) {
+      return (u8)id;
+    }
+  }
+  throw "unknown watch label, watch-labels.hpp needs regenerating";
+}
+
+#define START_MESEN_WATCH(label) POKE(0x4020, watch_id(label))
+#define STOP_MESEN_WATCH(label) POKE(0x4021, watch_id(label))
 #define BREAK_MESEN(label) break_mesen(label)
+#define LOG_LAG_FRAME(game_state, sub_state)                                   \
+  log_lag_frame((u8)(game_state), (u8)(sub_state))
+
+#ifdef CPU_METER_ENABLED
+#include <nesdoug.h>
+
+// neslib's copy of PPU_MASK, which its NMI writes to the PPU every frame
+extern "C" volatile char PPU_MASK_VAR;
+
+// Tints the picture with a color emphasis per phase while it runs, so the
+// height of each tinted band shows how much of the frame that phase took,
+// on any emulator (or a capture of real hardware). Like nesdoug's
+// gray_line, it writes PPU_MASK itself: color_emphasis only changes
+// neslib's copy, which would show a single tint for the whole frame.
+namespace CpuMeter {
+  // the emphasis the game itself set (through SET_COLOR_EMPHASIS), which
+  // idle time goes back to
+  extern char Idle;
+  constexpr char Logic = COL_EMP_RED;
+  constexpr char Render = COL_EMP_GREEN;
+  constexpr char Board = COL_EMP_BLUE;
+  constexpr char Hud = COL_EMP_RED | COL_EMP_GREEN;
+} // namespace CpuMeter
+
+#define CPU_METER(phase)                                                       \
+  POKE(0x2001, (u8)((PPU_MASK_VAR & 0x1f) | CpuMeter::phase))
+#define SET_COLOR_EMPHASIS(color)                                              \
+  do {                                                                         \
+    CpuMeter::Idle = (color);                                                  \
+    color_emphasis(CpuMeter::Idle);                                            \
+  } while (0)
+#else
+#define CPU_METER(phase)                                                       \
+  do {                                                                         \
+  } while (0)
+#define SET_COLOR_EMPHASIS(color) color_emphasis(color)
+#endif
 // fake assert works by basically breaking compilation if condition is false
 // ... by the simple fact that the thing usiing it can't be statically compiled
 // anymore
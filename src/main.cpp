@@ -8,6 +8,7 @@
 #include "gameplay.hpp"
 #include "ggsound.hpp"
 #include "maze-defs.hpp"
+#include "movie.hpp"
 #include "title-screen.hpp"
 
 #include "soundtrack-ptr.hpp"
@@ -32,7 +33,12 @@ bool ending_triggered;
 
 static void main_init() {
   previous_game_state = GameState::None;
+#ifdef HEADLESS
+  // every run comes from the input stream, menus are never shown
+  current_game_state = GameState::Gameplay;
+#else
   current_game_state = GameState::TitleScreen;
+#endif
   current_game_mode = GameMode::Story;
   current_controller_scheme = ControllerScheme::OnePlayer;
   select_reminder = SelectReminder::NeedToRemind;
@@ -78,8 +84,13 @@ int main() {
     }; break;
     case GameState::Gameplay: {
       ScopedBank bank(Gameplay::BANK);
+      Movie::start();
       Gameplay gameplay;
       gameplay.loop();
+      Movie::stop();
+#ifdef HEADLESS
+      current_game_state = GameState::Gameplay;
+#endif
     }; break;
     case GameState::WorldMap: {
       ScopedBank bank(WorldMap::BANK);
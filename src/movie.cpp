@@ -0,0 +1,184 @@
+#include "movie.hpp"
+
+#ifdef INPUT_MOVIE_MODE
+
+#include "cheats.hpp"
+#include "rng.hpp"
+#include <peekpoke.h>
+
+#pragma clang section text = ".prg_rom_0.text.movie"
+#pragma clang section rodata = ".prg_rom_0.rodata.movie"
+
+namespace Movie {
+  static u8 held[2];
+  static u8 pressed[2];
+
+  // current run of identical frames
+  static u8 run_frames;
+  static u8 run_pads[2];
+
+  static void update_pads(u8 pad_0, u8 pad_1) {
+    pressed[0] = (u8)(pad_0 & ~held[0]);
+    pressed[1] = (u8)(pad_1 & ~held[1]);
+    held[0] = pad_0;
+    held[1] = pad_1;
+  }
+
+  u8 pad_held(u8 pad) { return held[pad]; }
+  u8 pad_pressed(u8 pad) { return pressed[pad]; }
+
+#if INPUT_MOVIE_MODE == 1
+  static u8 cheat_bits() {
+    u8 bits = 0;
+    if (cheats.higher_score) {
+      bits |= CHEAT_HIGHER_SCORE;
+    }
+    if (cheats.higher_level) {
+      bits |= CHEAT_HIGHER_LEVEL;
+    }
+    if (cheats.infinite_energy) {
+      bits |= CHEAT_INFINITE_ENERGY;
+    }
+    if (cheats.fixed_polyomino) {
+      bits |= CHEAT_FIXED_POLYOMINO;
+    }
+    if (cheats.automino) {
+      bits |= CHEAT_AUTOMINO;
+    }
+    return bits;
+  }
+#else
+  static void set_cheats(u8 bits) {
+    cheats.higher_score = bits & CHEAT_HIGHER_SCORE;
+    cheats.higher_level = bits & CHEAT_HIGHER_LEVEL;
+    cheats.infinite_energy = bits & CHEAT_INFINITE_ENERGY;
+    cheats.fixed_polyomino = bits & CHEAT_FIXED_POLYOMINO;
+    cheats.automino = bits & CHEAT_AUTOMINO;
+  }
+#endif
+
+#if INPUT_MOVIE_MODE == 1
+  // buttons held since before the run, not recorded until released
+  static u8 ignored[2];
+
+  bool finished() { return false; }
+
+  static void flush_run() {
+    if (run_frames == 0) {
+      return;
+    }
+    POKE(0x4027, run_frames);
+    POKE(0x4027, run_pads[0]);
+    POKE(0x4027, run_pads[1]);
+    run_frames = 0;
+  }
+
+  void start() {
+    u8 seed_high = Rng::next();
+    u16 seed = (u16)(seed_high << 8 | Rng::next());
+    Rng::seed(seed);
+    POKE(0x4026, (u8)current_stage);
+    POKE(0x4026, (u8)current_game_mode);
+    POKE(0x4026, (u8)current_controller_scheme);
+    POKE(0x4026, cheat_bits());
+    POKE(0x4026, (u8)(seed >> 8));
+    POKE(0x4026, (u8)seed);
+    run_frames = 0;
+    held[0] = held[1] = 0;
+    ignored[0] = ignored[1] = 0;
+  }
+
+  void stop() {
+    flush_run();
+    POKE(0x4027, 0);
+  }
+
+  void ignore_held_pads() {
+    ignored[0] = (u8)pad_state(0);
+    ignored[1] = (u8)pad_state(1);
+  }
+
+  void poll_pads() {
+    pad_poll(0);
+    pad_poll(1);
+    ignored[0] &= (u8)pad_state(0);
+    ignored[1] &= (u8)pad_state(1);
+    u8 pad_0 = (u8)(pad_state(0) & ~ignored[0]);
+    u8 pad_1 = (u8)(pad_state(1) & ~ignored[1]);
+    if (run_frames == 0xff || pad_0 != run_pads[0] || pad_1 != run_pads[1]) {
+      flush_run();
+      run_pads[0] = pad_0;
+      run_pads[1] = pad_1;
+    }
+    run_frames++;
+    update_pads(pad_0, pad_1);
+  }
+#else
+  static bool replaying;
+
+#if INPUT_MOVIE_MODE == 2
+  // built from INPUT_MOVIE_FILE by movie.s
+  extern "C" const u8 input_movie[];
+
+  static const u8 *cursor;
+
+  static u8 next_byte() { return *cursor++; }
+#else
+  static u8 next_byte() { return PEEK(0x4028); }
+#endif
+
+  void start() {
+#if INPUT_MOVIE_MODE == 2
+    // only the first run replays
+    if (cursor != nullptr) {
+      return;
+    }
+    cursor = input_movie;
+#endif
+    current_stage = (Stage)next_byte();
+    current_game_mode = (GameMode)next_byte();
+    current_controller_scheme = (ControllerScheme)next_byte();
+    set_cheats(next_byte());
+    u8 seed_high = next_byte();
+    Rng::seed((u16)(seed_high << 8 | next_byte()));
+    run_frames = 0;
+    replaying = true;
+    held[0] = held[1] = 0;
+  }
+
+  void stop() { replaying = false; }
+
+  // movies already start with the buttons released
+  void ignore_held_pads() {}
+
+  bool finished() { return !replaying; }
+
+  void poll_pads() {
+#if INPUT_MOVIE_MODE == 2
+    pad_poll(0);
+    pad_poll(1);
+#endif
+    if (replaying && run_frames == 0) {
+      run_frames = next_byte();
+      if (run_frames == 0) {
+        replaying = false;
+      } else {
+        run_pads[0] = next_byte();
+        run_pads[1] = next_byte();
+      }
+    }
+    if (replaying) {
+      run_frames--;
+      update_pads(run_pads[0], run_pads[1]);
+    } else {
+#if INPUT_MOVIE_MODE == 2
+      update_pads((u8)pad_state(0), (u8)pad_state(1));
+#else
+      update_pads(0, 0);
+#endif
+    }
+  }
+#endif
+} // namespace Movie
+
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common.hpp"
+#include <nesdoug.h>
+#include <neslib.h>
+
+// Input movies, for reproducing a gameplay run exactly (see INPUT_MOVIE in
+// CMakeLists.txt). A movie holds what a run starts from and both pads'
+// states on each of its frames (from the first one after the stage's intro,
+// which HEADLESS builds skip), as runs of identical frames:
+//   stage, game mode, controller scheme, cheats (CHEAT_* bits),
+//   RNG seed (hi, lo), then (frames, pad 0, pad 1) runs, ending with a
+//   0 frames run
+// Recording debug builds seed the RNG on each run and send its movie to
+// tools/log.lua, which saves it as movie-N.bin; replaying debug builds play
+// the movie built into the ROM in place of the pads on the first run, then
+// go back to the pads once it ends.
+// HEADLESS builds (in any build type) read every run's movie from $4028, as
+// fed by tools/headless.lua, and end the run when it ends.
+#if defined(HEADLESS)
+#define INPUT_MOVIE_MODE 3
+#elif !defined(NDEBUG) && defined(INPUT_MOVIE_RECORD)
+#define INPUT_MOVIE_MODE 1
+#elif !defined(NDEBUG) && defined(INPUT_MOVIE_REPLAY)
+#define INPUT_MOVIE_MODE 2
+#endif
+
+namespace Movie {
+  constexpr u8 BANK = 0; // same as Gameplay
+
+  // bits of the movie header's cheats byte
+  constexpr u8 CHEAT_HIGHER_SCORE = 0x01;
+  constexpr u8 CHEAT_HIGHER_LEVEL = 0x02;
+  constexpr u8 CHEAT_INFINITE_ENERGY = 0x04;
+  constexpr u8 CHEAT_FIXED_POLYOMINO = 0x08;
+  constexpr u8 CHEAT_AUTOMINO = 0x10;
+
+#ifdef INPUT_MOVIE_MODE
+  // starts a gameplay run: records its seed and cheats, or replays the
+  // movie's
+  __attribute__((noinline)) void start();
+
+  // ends a gameplay run, terminating the movie being recorded
+  __attribute__((noinline)) void stop();
+
+  // leaves buttons held since before the run (such as the press skipping
+  // the intro) out of the movie, until they're released
+  __attribute__((noinline)) void ignore_held_pads();
+
+  // polls (or replays) both pads for the current frame
+  __attribute__((noinline)) void poll_pads();
+
+  // buttons held on a pad
+  u8 pad_held(u8 pad);
+
+  // buttons pressed on a pad since the previous frame
+  u8 pad_pressed(u8 pad);
+
+  // the movie being replayed has ended
+  bool finished();
+#else
+  inline void start() {}
+  inline void stop() {}
+  inline void ignore_held_pads() {}
+  inline void poll_pads() {
+    pad_poll(0);
+    pad_poll(1);
+  }
+  inline u8 pad_held(u8 pad) { return (u8)pad_state((char)pad); }
+  inline u8 pad_pressed(u8 pad) { return (u8)get_pad_new((char)pad); }
+  inline bool finished() { return false; }
+#endif
+} // namespace Movie
@@ -0,0 +1,8 @@
+; input movie replayed by INPUT_MOVIE=REPLAY builds; see movie.hpp
+.section .prg_rom_0.rodata.movie,"aR",@progbits
+
+.global input_movie
+input_movie:
+  .incbin "movie.bin"
+  ; in case the file was cut short
+  .byte 0, 0, 0
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "common.hpp"
+#include "donut.hpp"
+#include "zx02.hpp"
+#include <neslib.h>
+
+// codecs tools/asset-packer can choose from
+enum class Codec : u8 {
+  Raw,
+  RLE,
+  Donut,
+  ZX02,
+};
+
+struct PackedAsset {
+  Codec codec;
+  u16 size; // unpacked size, in bytes
+};
+
+// Unpacks an asset to vram_dest, which must also be the current VRAM address.
+// Remember to turn off rendering before using; Donut only runs from
+// ASSETS_BANK.
+__attribute__((always_inline)) inline void
+unpack_to_vram(PackedAsset asset, const void *data, int vram_dest) {
+  switch (asset.codec) {
+  case Codec::Raw:
+    vram_write(data, asset.size);
+    break;
+  case Codec::RLE:
+    vram_unrle(data);
+    break;
+  case Codec::Donut:
+    Donut::decompress_to_ppu((void *)data, (char)(asset.size / 64));
+    break;
+  case Codec::ZX02:
+    zx02_decompress_to_vram((void *)data, vram_dest);
+    break;
+  }
+}
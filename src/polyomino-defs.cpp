@@ -4,6 +4,7 @@
 #include "board-animation.hpp"
 #include "board.hpp"
 #include "common.hpp"
+#include "polyomino.hpp"
 #include "polyominos-metasprites.hpp"
 #include <nesdoug.h>
 #include <neslib.h>
@@ -28,11 +29,12 @@ void PolyominoDef::render(u8 x, int y) const {
   u8 bank = current_stage == Stage::StarlitStables
                 ? POLYOMINO_METASPRITE_MAIN_BANK
                 : POLYOMINO_METASPRITE_ALT_BANK;
-  auto ptr = banked_lambda(POLYOMINO_METASPRITE_MAIN_BANK, [index, bank] {
-    return bank == POLYOMINO_METASPRITE_MAIN_BANK
-               ? PolyominoMetaspriteMain::all_pieces[index]
-               : PolyominoMetaspriteAlt::all_pieces[index];
-  });
+  auto ptr = banked_call<Polyomino::BANK, POLYOMINO_METASPRITE_MAIN_BANK>(
+      [index, bank] {
+        return bank == POLYOMINO_METASPRITE_MAIN_BANK
+                   ? PolyominoMetaspriteMain::all_pieces[index]
+                   : PolyominoMetaspriteAlt::all_pieces[index];
+      });
   banked_oam_meta_spr(bank, x, y, ptr);
   return;
 }
@@ -101,12 +103,14 @@ bool PolyominoDef::board_render(Board &board, s8 row, s8 column) const {
     s8 block_row = row + delta.delta_row;
     u8 block_column = (u8)(column + delta.delta_column);
     if (block_row >= 0) {
-      banked_lambda(BoardAnimation::BANK, [&board, block_row, block_column]() {
-        board.add_animation(BoardAnimation(&BoardAnimation::block_jiggle,
-                                           (u8)block_row, (u8)block_column));
-        // XXX: just so line clears can be counted
-        board.occupy((u8)block_row, (u8)block_column);
-      });
+      banked_call<Polyomino::BANK, BoardAnimation::BANK>(
+          [&board, block_row, block_column]() {
+            board.add_animation(BoardAnimation(&BoardAnimation::block_jiggle,
+                                               (u8)block_row,
+                                               (u8)block_column));
+            // XXX: just so line clears can be counted
+            board.occupy((u8)block_row, (u8)block_column);
+          });
     } else {
       it_fits = false;
     }
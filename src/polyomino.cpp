@@ -16,13 +16,13 @@
 #pragma clang section rodata = ".prg_rom_14.rodata.polyominos"
 
 // NOTE: source file defines indices [0, 4) as littleminos
-auto Polyomino::littleminos = Bag<u8, 4>();
+Bag<u8, 4> Polyomino::littleminos;
 
 // NOTE: source file defines indices [11, 28) as pentominos
-auto Polyomino::pentominos = Bag<u8, 17>();
+Bag<u8, 17> Polyomino::pentominos;
 
 // NOTE: source file defines indices [4, 11) as tetrominos
-auto Polyomino::pieces = Bag<u8, 10>();
+Bag<u8, 10> Polyomino::pieces;
 
 Polyomino::Polyomino(Board &board)
     : state(State::Inactive), board(board), definition(NULL) {}
@@ -87,6 +87,7 @@ void Polyomino::spawn() {
   state = State::Active;
   lock_down_timer = 0;
   lock_down_moves = 0;
+  drop_timer = 0;
   move_timer = 0;
   rotate_timer = 0;
   action = Action::Idle;
@@ -115,7 +116,7 @@ void Polyomino::update_bitmask() {
   auto ptr = definition->bitmasks + (column + 3);
 
   // TODO: constantize bitmasks bank number
-  banked_lambda(13, [this, ptr]() {
+  banked_call<BANK, 13>([this, ptr]() {
 #pragma clang loop unroll(full)
     for (u8 i = 0; i < 4; i++) {
       bitmask[i] = (*ptr)[i];
@@ -57,6 +57,11 @@ public:
   void outside_render(int y_scroll);
   void spawn_update();
 
+  // bench/ times collide and update_shadow on their own
+  friend struct Benchmark;
+  // plays the polyomino in automino mode
+  friend class Automino;
+
 private:
   enum class Action {
     Idle = 0,
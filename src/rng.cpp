@@ -0,0 +1,70 @@
+#include "rng.hpp"
+#include "common.hpp"
+
+namespace Rng {
+  // same starting point as neslib's generator
+  static constexpr u16 DEFAULT_SEED = 0xfdfd;
+
+  static u8 state_low = (u8)DEFAULT_SEED;
+  static u8 state_high = (u8)(DEFAULT_SEED >> 8);
+
+  static u8 pool[POOL_SIZE];
+  static u8 pool_start;
+  static u8 pool_count;
+
+  // xorshift with shifts (7, 9, 8), a byte at a time
+  static u8 step() {
+    // x ^= x << 7
+    state_high ^= (u8)(state_high << 7 | state_low >> 1);
+    state_low ^= (u8)(state_low << 7);
+    // x ^= x >> 9
+    state_low ^= state_high >> 1;
+    // x ^= x << 8
+    state_high ^= state_low;
+    return state_high;
+  }
+
+  void seed(u16 seed) {
+    if (seed == 0) {
+      seed = DEFAULT_SEED;
+    }
+    state_low = (u8)seed;
+    state_high = (u8)(seed >> 8);
+    pool_start = 0;
+    pool_count = 0;
+  }
+
+  u8 next() {
+    if (pool_count == 0) {
+      return step();
+    }
+    u8 value = pool[pool_start];
+    pool_start = (pool_start + 1) & (POOL_SIZE - 1);
+    pool_count--;
+    return value;
+  }
+
+  u8 up_to(u8 n) {
+    if (n < 2) {
+      return 0;
+    }
+    // the smallest 2^k - 1 covering n - 1; values past it are drawn again,
+    // which happens less than half of the time
+    u8 mask = n - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    u8 result;
+    do {
+      result = next() & mask;
+    } while (result >= n);
+    return result;
+  }
+
+  void refill() {
+    while (pool_count < POOL_SIZE) {
+      pool[(pool_start + pool_count) & (POOL_SIZE - 1)] = step();
+      pool_count++;
+    }
+  }
+} // namespace Rng
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common.hpp"
+
+// The game's random numbers: a 16-bit xorshift generator, plus a pool of
+// its next few outputs filled in idle time, so that game logic mostly just
+// reads them. The pool keeps the outputs in order, so the sequence depends
+// only on the seed (which input movies record), never on when the pool got
+// refilled.
+namespace Rng {
+  static constexpr u8 POOL_SIZE = 8;
+
+  // any seed works; 0, where xorshift would get stuck, is taken as another
+  void seed(u16 seed);
+
+  // the next random byte
+  u8 next();
+
+  // uniformly random in [0, n), or 0 when n < 2
+  __attribute__((noinline)) u8 up_to(u8 n);
+
+  // fills the pool up; call it when there's time to spare
+  void refill();
+} // namespace Rng
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "common.hpp"
+#include <array>
+#include <cstddef>
+
+/* Something almost but not quite like entirely different from coroutines
+  Each Task keeps its own resume point plus a frame with whatever has to
+  survive a yield (for example, the current index on a for loop), so one
+  function can have many instances in flight, one per Task object.
+
+ Example:
+
+  struct CounterFrame {
+    int index;
+  };
+  Task<CounterFrame> counter_task;
+
+  bool counter(Task<CounterFrame> &task) {
+    TASK_BEGIN(task);
+
+    for (task.index = 0; task.index <= 10; task.index++) {
+      TASK_YIELD(task, true);
+    }
+
+    TASK_FINISH(task, false);
+  }
+
+ */
+
+template <typename Frame> struct Task : Frame {
+  void *resume_point = NULL;
+
+  bool running() const { return resume_point != NULL; }
+  void reset() { resume_point = NULL; }
+};
+
+#define _TOKEN_PASTE(x, y) x##y
+#define _CAT(x, y) _TOKEN_PASTE(x, y)
+#define UNIQUE_LABEL _CAT(step_, __LINE__)
+
+#define TASK_BEGIN(task)                                                       \
+  if ((task).resume_point != NULL) {                                           \
+    goto *(task).resume_point;                                                 \
+  }
+
+#define TASK_YIELD(task, ...)                                                  \
+  (task).resume_point = &&UNIQUE_LABEL;                                        \
+  return __VA_ARGS__;                                                          \
+  UNIQUE_LABEL:
+#define TASK_FINISH(task, ...)                                                 \
+  (task).resume_point = NULL;                                                  \
+  return __VA_ARGS__
+
+// Runs up to N tasks side by side, each at most one step per run(); a task
+// is a method returning true while it still has steps to go, plus a rough
+// cost in cycles for one of its steps. Tasks run from the scheduler's bank,
+// so they must live in the same bank as its caller (or in the fixed bank).
+template <u8 N> class TaskScheduler {
+  struct Slot {
+    bool (*step)(void *);
+    void *self;
+    u16 cost;
+  };
+
+  std::array<Slot, N> slots;
+  u8 count;
+  u8 next; // where the last run ran out of budget
+
+  template <typename T, bool (T::*method)()> static bool step(void *self) {
+    return (static_cast<T *>(self)->*method)();
+  }
+
+public:
+  TaskScheduler() : count(0), next(0) {};
+
+  void reset() {
+    count = 0;
+    next = 0;
+  }
+
+  template <typename T, bool (T::*method)()> bool scheduled(T *self) const {
+    for (u8 i = 0; i < count; i++) {
+      if (slots[i].step == &step<T, method> && slots[i].self == self) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // returns false when all slots are taken
+  template <typename T, bool (T::*method)()>
+  bool spawn(T *self, u16 cost) {
+    if (count == N) {
+      return false;
+    }
+    slots[count++] = {&step<T, method>, self, cost};
+    return true;
+  }
+
+  // steps tasks in turn while their costs fit in the budget, picking up
+  // where the previous run stopped; the first one always runs, so nothing
+  // starves. Finished tasks are dropped; returns true while any is going
+  bool run(u16 budget) {
+    bool first = true;
+    for (u8 left = count; left > 0; left--) {
+      if (next >= count) {
+        next = 0;
+      }
+      Slot &slot = slots[next];
+      if (!first && slot.cost > budget) {
+        break;
+      }
+      first = false;
+      budget = slot.cost > budget ? 0 : budget - slot.cost;
+
+      if (slot.step(slot.self)) {
+        next++;
+      } else {
+        for (u8 i = next + 1; i < count; i++) {
+          slots[i - 1] = slots[i];
+        }
+        count--;
+      }
+    }
+    return count > 0;
+  }
+};
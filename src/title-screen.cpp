@@ -11,6 +11,7 @@
 #include "common.hpp"
 #include "ggsound.hpp"
 #include "metasprites.hpp"
+#include "rng.hpp"
 #include "soundtrack.hpp"
 #include "title-screen.hpp"
 
@@ -59,7 +60,7 @@ TitleScreen::TitleScreen()
     : state(State::MainMenu), current_option(MenuOption::OnePlayer),
       current_track(Song::Marshmallow_mountain), next_track_delay(0),
       y_scroll(TITLE_SCROLL) {
-  banked_lambda(ASSETS_BANK, []() { load_title_assets(); });
+  banked_call<BANK, ASSETS_BANK>([]() { load_title_assets(); });
 
   pal_bright(0);
 
@@ -130,7 +131,7 @@ void TitleScreen::loop() {
     pad_poll(0);
     pad_poll(1);
 
-    rand16();
+    Rng::next();
 
     u8 pressed = get_pad_new(0) | get_pad_new(1);
 
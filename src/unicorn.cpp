@@ -7,7 +7,6 @@
 #include "board.hpp"
 #include "cheats.hpp"
 #include "common.hpp"
-#include "coroutine.hpp"
 #include "direction.hpp"
 #include "energy-sprites.hpp"
 #include "fixed-point.hpp"
@@ -25,10 +24,10 @@
 Unicorn::Unicorn(Board &board, fixed_point starting_x, fixed_point starting_y)
     : state(State::Idle), x(starting_x), y(starting_y),
       row(starting_y.whole >> 4), column(starting_x.whole >> 4),
-      score(cheats.higher_score ? 8000 : 0), energy(STARTING_ENERGY),
-      statue(false), board(board), facing(Direction::Right),
-      moving(Direction::Right), energy_timer(0),
-      original_energy(STARTING_ENERGY) {
+      score_digits(cheats.higher_score ? 0x8000 : 0x0000),
+      energy(STARTING_ENERGY), score_hud_dirty(true), statue(false),
+      board(board), facing(Direction::Right), moving(Direction::Right),
+      energy_timer(0), original_energy(STARTING_ENERGY), buffered_input(0) {
   left_animation = Animation{&moving_left_cells};
   right_animation = Animation{&moving_right_cells};
   left_tired_animation = Animation{&trudging_left_cells};
@@ -134,35 +133,31 @@ void Unicorn::update(u8 pressed, u8 held, bool roll_disabled) {
       set_state(State::Roll);
       roll_distance = 0;
       bool occupied = false;
+      // cell_at and occupied are in the fixed bank, no need to switch
       if (facing == Direction::Right) {
-        banked_lambda(Board::BANK, [this, &occupied]() {
-          while (roll_distance < 3) {
-            bool wall = board.cell_at(row, column + roll_distance).right_wall;
-            occupied = board.occupied((s8)row, column + roll_distance + 1);
-            if (wall || occupied) {
-              break;
-            }
-            roll_distance++;
+        while (roll_distance < 3) {
+          bool wall = board.cell_at(row, column + roll_distance).right_wall;
+          occupied = board.occupied((s8)row, column + roll_distance + 1);
+          if (wall || occupied) {
+            break;
           }
-        });
+          roll_distance++;
+        }
       } else {
-        banked_lambda(Board::BANK, [this, &occupied]() {
-          while (roll_distance < 3) {
-            bool wall = board.cell_at(row, column - roll_distance).left_wall;
-            occupied = board.occupied((s8)row, column - roll_distance - 1);
-            if (wall || occupied) {
-              break;
-            }
-            roll_distance++;
+        while (roll_distance < 3) {
+          bool wall = board.cell_at(row, column - roll_distance).left_wall;
+          occupied = board.occupied((s8)row, column - roll_distance - 1);
+          if (wall || occupied) {
+            break;
           }
-        });
+          roll_distance++;
+        }
       }
       roll_into_block = (roll_distance < 3 && occupied);
       break;
     }
 
-    auto current_cell = banked_lambda(
-        Board::BANK, [this]() { return board.cell_at(row, column); });
+    auto current_cell = board.cell_at(row, column);
 
 #define PRESS_HELD(button)                                                     \
   ((pressed & (button)) ||                                                     \
@@ -303,12 +298,12 @@ void Unicorn::update(u8 pressed, u8 held, bool roll_disabled) {
       GGSound::play_sfx(SFX::Blockhit, GGSound::SFXPriority::Two);
       if (facing == Direction::Right) {
         if (board.occupied((s8)row, column + 2)) {
-          banked_lambda(BoardAnimation::BANK, [this]() {
+          banked_call<BANK, BoardAnimation::BANK>([this]() {
             board.add_animation(BoardAnimation(
                 &BoardAnimation::block_break_right, row, column + 1));
           });
         } else {
-          banked_lambda(BoardAnimation::BANK, [this]() {
+          banked_call<BANK, BoardAnimation::BANK>([this]() {
             board.add_animation(BoardAnimation(
                 &BoardAnimation::block_move_right, row, column + 1));
             board.add_animation(BoardAnimation(
@@ -317,12 +312,12 @@ void Unicorn::update(u8 pressed, u8 held, bool roll_disabled) {
         }
       } else {
         if (board.occupied((s8)row, column - 2)) {
-          banked_lambda(BoardAnimation::BANK, [this]() {
+          banked_call<BANK, BoardAnimation::BANK>([this]() {
             board.add_animation(BoardAnimation(
                 &BoardAnimation::block_break_left, row, column - 1));
           });
         } else {
-          banked_lambda(BoardAnimation::BANK, [this]() {
+          banked_call<BANK, BoardAnimation::BANK>([this]() {
             board.add_animation(BoardAnimation(&BoardAnimation::block_move_left,
                                                row, column - 1));
             board.add_animation(BoardAnimation(
@@ -426,14 +421,15 @@ void Unicorn::feed(u8 nutrition) {
 }
 
 void Unicorn::add_score(u8 points) {
-  score += points;
-
-  if (score > 9999) {
-    score = 9999;
+  if (points == 0 || score_digits == 0x9999) {
+    return;
   }
+  score_digits = bcd_add(score_digits, points);
+  score_hud_dirty = true;
 
-  if (score > high_score[(u8)current_stage]) {
-    high_score[(u8)current_stage] = score;
+  // packed BCD compares just like binary
+  if (score_digits > high_score[(u8)current_stage]) {
+    high_score[(u8)current_stage] = score_digits;
   }
 }
 
@@ -449,36 +445,38 @@ void render_energy_hud(int y_scroll, u8 value) {
 }
 
 void Unicorn::refresh_energy_hud(int y_scroll) {
-  static u8 animation_frames, step = 0;
+  auto &task = energy_hud_blink;
 
-  CORO_INIT;
+  TASK_BEGIN(task);
 
   if (original_energy == energy) {
     render_energy_hud(y_scroll, energy);
-    CORO_FINISH();
-    return;
+    TASK_FINISH(task);
   }
 
-  for (step = 0; step < 4; step++) {
-    for (animation_frames = 0; animation_frames < 4; animation_frames++) {
-      render_energy_hud(y_scroll, (step & 0b1) == 0 ? energy : original_energy);
-      CORO_YIELD();
+  for (task.step = 0; task.step < 4; task.step++) {
+    for (task.animation_frames = 0; task.animation_frames < 4;
+         task.animation_frames++) {
+      render_energy_hud(y_scroll,
+                        (task.step & 0b1) == 0 ? energy : original_energy);
+      TASK_YIELD(task);
     }
   }
 
   original_energy = energy;
   render_energy_hud(y_scroll, energy);
 
-  CORO_FINISH();
+  TASK_FINISH(task);
 }
 
 void Unicorn::refresh_score_hud() {
-  // refresh hunger hud
   u8 score_text[4];
 
-  int_to_text(score_text, score);
+  bcd_to_text(score_text, score_digits);
   multi_vram_buffer_horz(score_text, 4, NTADR_A(22, 27));
 
-  int_to_text(score_text, high_score[(u8)current_stage]);
+  bcd_to_text(score_text, high_score[(u8)current_stage]);
   multi_vram_buffer_horz(score_text, 4, NTADR_A(23, 4));
+
+  score_hud_dirty = false;
 }
@@ -4,6 +4,7 @@
 #include "board.hpp"
 #include "direction.hpp"
 #include "fixed-point.hpp"
+#include "task.hpp"
 
 class Unicorn {
   static constexpr fixed_point DEFAULT_MOVE_SPEED = 1.14453125_fp;
@@ -31,8 +32,9 @@ public:
   fixed_point y;
   u8 row;
   u8 column;
-  u16 score;
+  u16 score_digits; // in packed BCD, for the HUD and the high score
   u8 energy;
+  bool score_hud_dirty;
 
   bool left_wall, right_wall;
   bool statue;
@@ -47,6 +49,7 @@ public:
   void render(int y_scroll);
   void feed(u8 nutrition);
   void refresh_energy_hud(int y_scroll);
+  // only needed while score_hud_dirty is set
   void refresh_score_hud();
   void add_score(u8 points);
 
@@ -59,6 +62,12 @@ private:
   u8 energy_timer;
   u8 original_energy;
 
+  struct EnergyHudBlinkFrame {
+    u8 step;
+    u8 animation_frames;
+  };
+  Task<EnergyHudBlinkFrame> energy_hud_blink;
+
   u8 roll_distance;
   bool roll_into_block;
 
@@ -31,65 +31,11 @@ void u8_to_text(u8 score_text[], u8 value) {
   score_text[1] = DIGITS_BASE_TILE + (u8)value;
 }
 
-__attribute__((always_inline)) void int_to_text(u8 score_text[], u16 value) {
-  score_text[0] = 0;
-  if (value >= 8000) {
-    score_text[0] |= 8;
-    value -= 8000;
-  }
-  if (value >= 4000) {
-    score_text[0] |= 4;
-    value -= 4000;
-  }
-  if (value >= 2000) {
-    score_text[0] |= 2;
-    value -= 2000;
-  }
-  if (value >= 1000) {
-    score_text[0] |= 1;
-    value -= 1000;
-  }
-  score_text[0] += DIGITS_BASE_TILE;
-
-  score_text[1] = 0;
-  if (value >= 800) {
-    score_text[1] |= 8;
-    value -= 800;
-  }
-  if (value >= 400) {
-    score_text[1] |= 4;
-    value -= 400;
-  }
-  if (value >= 200) {
-    score_text[1] |= 2;
-    value -= 200;
-  }
-  if (value >= 100) {
-    score_text[1] |= 1;
-    value -= 100;
-  }
-  score_text[1] += DIGITS_BASE_TILE;
-
-  score_text[2] = 0;
-  if (value >= 80) {
-    score_text[2] |= 8;
-    value -= 80;
-  }
-  if (value >= 40) {
-    score_text[2] |= 4;
-    value -= 40;
-  }
-  if (value >= 20) {
-    score_text[2] |= 2;
-    value -= 20;
-  }
-  if (value >= 10) {
-    score_text[2] |= 1;
-    value -= 10;
-  }
-  score_text[2] += DIGITS_BASE_TILE;
-
-  score_text[3] = DIGITS_BASE_TILE + (u8)value;
+void bcd_to_text(u8 score_text[], u16 bcd) {
+  score_text[0] = DIGITS_BASE_TILE + (u8)(bcd >> 12);
+  score_text[1] = DIGITS_BASE_TILE + (u8)((bcd >> 8) & 0x0f);
+  score_text[2] = DIGITS_BASE_TILE + (u8)((u8)bcd >> 4);
+  score_text[3] = DIGITS_BASE_TILE + (u8)(bcd & 0x0f);
 
   // leading zeroes are darker
   for (u8 i = 0; i < 3; i++) {
@@ -100,19 +46,44 @@ __attribute__((always_inline)) void int_to_text(u8 score_text[], u16 value) {
   }
 }
 
-const u8 mask[] = {0x00, 0x00, 0x01, 0x03, 0x03, 0x07, 0x07, 0x07, 0x07, 0x0f,
-                   0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x0f, 0x1f, 0x1f};
-
-u8 rand_up_to(u8 n) {
-  if (n < 2) {
-    return 0;
-  }
-  u8 result = rand8() & mask[n];
-  if (result >= n) {
-    result = rand8() & mask[n];
+u16 bcd_add(u16 bcd, u8 value) {
+  u8 hundreds = 0;
+  while (value >= 100) {
+    value -= 100;
+    hundreds++;
   }
-  if (result >= n) {
-    result -= n;
+  u8 tens = 0;
+  while (value >= 10) {
+    value -= 10;
+    tens++;
   }
-  return result;
-}
\ No newline at end of file
+
+  u8 units = (u8)(bcd & 0x0f) + value;
+  if (units >= 10) {
+    units -= 10;
+    tens++;
+  }
+  tens += (u8)bcd >> 4;
+  if (tens >= 10) {
+    tens -= 10;
+    hundreds++;
+  }
+  hundreds += (u8)((bcd >> 8) & 0x0f);
+  u8 thousands = (u8)(bcd >> 12);
+  if (hundreds >= 10) {
+    hundreds -= 10;
+    thousands++;
+  }
+  if (thousands >= 10) {
+    return 0x9999;
+  }
+  return (u16)((u16)((thousands << 4) | hundreds) << 8 | (u8)(tens << 4) |
+               units);
+}
+
+u16 bcd_to_binary(u16 bcd) {
+  u8 high = (u8)(bcd >> 8);
+  u8 low = (u8)bcd;
+  return (u16)((high >> 4) * 1000 + (high & 0x0f) * 100) +
+         (u8)((low >> 4) * 10 + (low & 0x0f));
+}
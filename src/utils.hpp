@@ -1,12 +1,22 @@
 #pragma once
 
 #include "common.hpp"
-// #define RAND_UP_TO(n) ((u8)(((u16)rand8() * (u16)(n)) >> 8))
-// #define RAND_UP_TO(n) (rand8() % (n))
-#define RAND_UP_TO(n) (rand_up_to(n))
-#define RAND_UP_TO_POW2(n) (rand8() & ((1 << n) - 1))
+#include "rng.hpp"
+#define RAND_UP_TO(n) (Rng::up_to(n))
+#define RAND_UP_TO_POW2(n) (Rng::next() & ((1 << n) - 1))
 
 void u8_to_text(u8 score_text[], u8 value);
-void int_to_text(u8 score_text[], u16 value);
+void bcd_to_text(u8 score_text[], u16 bcd);
 
-__attribute__((noinline)) u8 rand_up_to(u8 n);
\ No newline at end of file
+// adds value to a 4 digit packed BCD number, saturating at 9999
+u16 bcd_add(u16 bcd, u8 value);
+
+// value of a 4 digit packed BCD number
+u16 bcd_to_binary(u16 bcd);
+
+// packed BCD form of value (up to 9999), for constants compared against
+// BCD numbers
+constexpr u16 to_bcd(u16 value) {
+  return (u16)((value / 1000) << 12 | (value / 100 % 10) << 8 |
+               (value / 10 % 10) << 4 | value % 10);
+}
@@ -1,4 +1,5 @@
 #include "world-map.hpp"
+#include "asset-manifest.hpp"
 #include "assets.hpp"
 #include "bank-helper.hpp"
 #include "banked-asset-helpers.hpp"
@@ -6,9 +7,11 @@
 #include "charset.hpp"
 #include "common.hpp"
 #include "ggsound.hpp"
+#include "log.hpp"
 #include "metasprites.hpp"
+#include "packed-asset.hpp"
+#include "rng.hpp"
 #include "soundtrack.hpp"
-#include "zx02.hpp"
 #include <nesdoug.h>
 #include <neslib.h>
 
@@ -55,7 +58,7 @@ const u8 *showcase_sprites[] = {(const u8 *)Metasprites::MirohMap,
                                 (const u8 *)Metasprites::BerriesHigh};
 
 WorldMap::WorldMap() {
-  load_map_assets();
+  banked_call<BANK, ASSETS_BANK>([]() { load_map_assets(); });
 
   vram_adr(NAMETABLE_A);
 
@@ -123,14 +126,20 @@ WorldMap::WorldMap() {
 
   if (show_intro) {
     vram_adr(NAMETABLE_C);
-    zx02_decompress_to_vram((void *)intro_text_nametable, NAMETABLE_C);
+    START_MESEN_WATCH("#nam intro");
+    unpack_to_vram(AssetManifest::intro_text_nametable, intro_text_nametable,
+                   NAMETABLE_C);
+    STOP_MESEN_WATCH("#nam intro");
     scroll(0, 0xf0);
   } else {
     render_sprites();
   }
   if (story_mode_beaten) {
     vram_adr(NAMETABLE_C);
-    zx02_decompress_to_vram((void *)ending_text_nametable, NAMETABLE_C);
+    START_MESEN_WATCH("#nam ending");
+    unpack_to_vram(AssetManifest::ending_text_nametable,
+                   ending_text_nametable, NAMETABLE_C);
+    STOP_MESEN_WATCH("#nam ending");
   }
   change_uni_palette();
 
@@ -176,7 +185,7 @@ void WorldMap::loop() {
     pad_poll(0);
     pad_poll(1);
 
-    rand16();
+    Rng::next();
 
     u8 pressed = get_pad_new(0) | get_pad_new(1);
 
@@ -251,7 +260,7 @@ void WorldMap::loop() {
         return;
       } else {
         current_game_state = GameState::Gameplay;
-        banked_lambda(Board::BANK, []() { board.generate_maze(); });
+        banked_call<BANK, Board::BANK>([]() { board.generate_maze(); });
       }
     } else if (pressed & (PAD_B)) {
       current_game_state = GameState::TitleScreen;
@@ -0,0 +1,326 @@
+; De-compressor for ZX02 files
+; ----------------------------
+;
+; Decompress ZX02 data (6502 optimized format), optimized for speed.
+; Same entry point and stream format as zx02.s; pick one of them with the
+; ZX02_DECODER cmake option.
+;
+; Differences from the size-optimized decoder:
+;  - the low byte of the source pointer lives in Y, so fetching a byte is
+;    just "lda (ZX0_src),y / iny";
+;  - bit fetching and byte fetching are inlined (only the Elias decoder is
+;    still a subroutine);
+;  - literals are copied two bytes per loop iteration;
+;  - the destination pointer is advanced once per literal/match instead of
+;    once per byte;
+;  - matches don't re-address the PPU for each byte: the source bytes are
+;    read in one go into a 64-byte RAM buffer and then written out. For
+;    offsets up to 64 the buffer holds a whole period of the match, so it
+;    is read once and replayed; for offset 1 (the most common case in our
+;    nametables) the single byte is just written N times. Longer offsets
+;    are copied in 64-byte chunks.
+;
+; The RAM buffer is the same one donut uses (the upper half of VRAM_BUF),
+; so, as with donut, only call this with rendering off.
+;
+; Compress with:
+;    zx02 input.bin output.zx0
+;
+; (c) 2022 DMSC
+; Code under MIT license, see LICENSE.zx02 file.
+;
+; (adapted for llvm-mos + vram by Wendel Scardua)
+
+.section .zp,"z",@nobits
+offset: .zero 2
+ZX0_src: .zero 2
+ZX0_dst: .zero 2
+bitr: .zero 1
+len: .zero 1
+chunk: .zero 1
+
+.section .prg_rom_fixed.text.zx02,"axR",@progbits
+
+PPU_ADDR = $2006
+PPU_DATA = $2007
+
+.global VRAM_BUF
+zx02_copy_buffer = VRAM_BUF + 0x40
+CHUNK_SIZE = 64
+
+; A = next byte from the compressed stream
+.macro get_byte
+              lda   (ZX0_src), y
+              iny
+              bne   8f
+              inc   ZX0_src+1
+8:
+.endm
+
+; C = next bit from the compressed stream (A is clobbered on refills)
+.macro get_bit
+              asl   bitr
+              bne   9f
+              get_byte
+              rol               ; C=1 from the marker bit
+              sta   bitr
+9:
+.endm
+
+; PPU address = ZX0_dst - offset - 1
+.macro address_match_source
+              clc
+              lda   ZX0_dst
+              sbc   offset
+              tax
+              lda   ZX0_dst+1
+              sbc   offset+1
+              sta   PPU_ADDR
+              stx   PPU_ADDR
+              lda   PPU_DATA    ; prime the read buffer
+.endm
+
+; PPU address = ZX0_dst
+.macro address_destination
+              lda   ZX0_dst+1
+              sta   PPU_ADDR
+              lda   ZX0_dst
+              sta   PPU_ADDR
+.endm
+
+; void zx02_decompress_to_vram(void *src, int vram_dest)
+.global zx02_decompress_to_vram
+zx02_decompress_to_vram:
+    sta ZX0_dst
+    stx ZX0_dst+1
+    ldy mos8(__rc2)
+    lda #$00
+    sta ZX0_src
+    lda mos8(__rc3)
+    sta ZX0_src+1
+
+    lda #$00
+    sta offset
+    sta offset+1
+    lda #$80
+    sta bitr
+
+;--------------------------------------------------
+; Decompress ZX0 data (6502 optimized format)
+
+; Decode literal: Copy next N bytes from compressed file
+;    Elias(length)  byte[1]  byte[2]  ...  byte[N]
+decode_literal:
+              jsr   get_elias
+              tax
+              bne   1f
+              inc   ZX0_dst+1   ; N = 256
+1:            adc   ZX0_dst     ; C=0 from get_elias
+              sta   ZX0_dst
+              bcc   2f
+              inc   ZX0_dst+1
+2:
+              ; copy an odd byte first, then pairs
+              txa
+              lsr
+              tax
+              bcc   3f
+              get_byte
+              sta   PPU_DATA
+              txa
+              beq   lit_done
+              bne   cop0
+3:            bne   cop0
+              ldx   #$80        ; N = 256
+cop0:
+              get_byte
+              sta   PPU_DATA
+              get_byte
+              sta   PPU_DATA
+              dex
+              bne   cop0
+lit_done:
+              get_bit
+              bcc   dzx0s_rep_offset
+              jmp   dzx0s_new_offset
+
+; Copy from last offset (repeat N bytes from last offset)
+;    Elias(length)
+dzx0s_rep_offset:
+              jsr   get_elias
+dzx0s_copy:
+              sta   len         ; 0 means 256
+              tya
+              pha
+
+              lda   offset+1
+              bne   1f
+              ldx   offset
+              beq   run_copy
+              cpx   #CHUNK_SIZE
+              bcc   near_copy
+1:            jmp   far_copy
+
+; offset <= 64: read a whole period of the match (or the whole match, if
+; it is shorter), then replay it
+near_copy:
+              inx
+              stx   chunk
+              lda   len
+              beq   1f
+              cmp   chunk
+              bcs   1f
+              sta   chunk
+1:
+              address_match_source
+              ldx   #0
+4:            lda   PPU_DATA
+              sta   zx02_copy_buffer, x
+              inx
+              cpx   chunk
+              bne   4b
+
+              address_destination
+              ldx   #0
+              ldy   len
+5:            lda   zx02_copy_buffer, x
+              sta   PPU_DATA
+              inx
+              cpx   chunk
+              bne   6f
+              ldx   #0
+6:            dey
+              bne   5b
+              beq   near_done
+
+; offset = 1: repeat the last byte
+run_copy:
+              address_match_source
+              lda   PPU_DATA
+              tax
+              address_destination
+              txa
+              ldy   len
+7:            sta   PPU_DATA
+              dey
+              bne   7b
+
+near_done:
+              lda   len
+              bne   1f
+              inc   ZX0_dst+1   ; N = 256
+1:            clc
+              adc   ZX0_dst
+              sta   ZX0_dst
+              bcc   copy_done
+              inc   ZX0_dst+1
+              bcs   copy_done
+
+; offset > 64: copy in chunks
+far_copy:
+              lda   len
+              beq   1f
+              cmp   #CHUNK_SIZE
+              bcc   2f
+1:            lda   #CHUNK_SIZE
+2:            sta   chunk
+
+              address_match_source
+              ldx   #0
+3:            lda   PPU_DATA
+              sta   zx02_copy_buffer, x
+              inx
+              cpx   chunk
+              bne   3b
+
+              address_destination
+              ldx   #0
+4:            lda   zx02_copy_buffer, x
+              sta   PPU_DATA
+              inx
+              cpx   chunk
+              bne   4b
+
+              txa
+              clc
+              adc   ZX0_dst
+              sta   ZX0_dst
+              bcc   5f
+              inc   ZX0_dst+1
+5:            lda   len
+              sec
+              sbc   chunk
+              sta   len
+              beq   copy_done
+              jmp   far_copy
+
+copy_done:
+              pla
+              tay
+              get_bit
+              bcs   dzx0s_new_offset
+              jmp   decode_literal
+
+; Copy from new offset (repeat N bytes from new offset)
+;    Elias(MSB(offset))  LSB(offset)  Elias(length-1)
+dzx0s_new_offset:
+              ; Read elias code for high part of offset
+              jsr   get_elias
+              tax
+              beq   exit  ; Read a 0, signals the end
+              ; Decrease and divide by 2
+              dex
+              txa
+              lsr
+              sta   offset+1
+
+              ; Get low part of offset, a literal 7 bits
+              get_byte
+
+              ; Divide by 2
+              ror
+              sta   offset
+
+              ; And get the copy length.
+              ; Start elias reading with the bit already in carry:
+              lda   #1
+              jsr   elias_skip1
+
+              adc   #1          ; C=0 from elias_skip1
+              jmp   dzx0s_copy
+
+; Read an elias-gamma interlaced code.
+; ------------------------------------
+; Returns the value in A (0 means 256) with C=0
+get_elias:
+              ; Initialize return value to #1
+              lda   #1
+              bne   elias_start
+
+elias_get:     ; Read next data bit to result
+              asl   bitr
+              bne   1f
+              tax
+              get_byte
+              rol
+              sta   bitr
+              txa
+1:            rol
+
+elias_start:
+              ; Get one bit
+              asl   bitr
+              bne   elias_skip1
+
+              ; Read new bit from stream
+              tax
+              get_byte
+              rol
+              sta   bitr
+              txa
+
+elias_skip1:
+              bcs   elias_get
+              ; Got ending bit, stop reading
+exit:
+              rts
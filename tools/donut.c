@@ -6,6 +6,10 @@
 #include <stdint.h>  /* uint8_t */
 #include <string.h>  /* memcpy() */
 #include <getopt.h>  /* getopt_long() */
+#include <pthread.h> /* pthread_create(), pthread_join() */
+#include <stdatomic.h> /* atomic_fetch_add() */
+#include <time.h>    /* clock_gettime() */
+#include <unistd.h>  /* sysconf() */
 
 const char *VERSION_TEXT = "Donut 1.7\n";
 const char *HELP_TEXT =
@@ -30,6 +34,10 @@ const char *HELP_TEXT =
 	"  --no-bit-flip          don't encode bit rotated blocks\n"
 	"  --cycle-limit INT      limits the 6502 decoding time for each encoded block,\n"
 	"                         must be at least 1268\n"
+	"  -j INT, --threads=INT  compress blocks on INT threads [default: CPU count],\n"
+	"                         output is the same for any thread count\n"
+	"  --benchmark            compress INPUT with 1 and with --threads threads,\n"
+	"                         reporting the speed of each (no output is written)\n"
 ;
 
 static int verbosity_level = 0;
@@ -655,6 +663,192 @@ int compress_blocks_with_dcb(buffer_pointers *result_p, bool allow_partial, bool
 	return DESTINATION_FULL;
 }
 
+/* Blocks are compressed independently, so the input can be split at block
+   boundaries and each part compressed on any thread; concatenating the
+   parts gives the same output as compressing all of it in one go. */
+typedef struct compress_job {
+	const uint8_t *src;
+	size_t src_length;
+	bool allow_partial;
+	bool use_bit_flip;
+	int cycle_limit;
+	uint8_t *buffer;
+	size_t dest_length;
+	int status;
+} compress_job;
+
+/* Parts are small, and a fixed set of workers takes the next one from a
+   shared counter whenever it's done with its last, so the threads keep
+   busy until the very end even when some parts cost more than others. */
+#define BLOCKS_PER_JOB 16
+
+typedef struct compress_pool {
+	compress_job *jobs;
+	size_t number_of_jobs;
+	atomic_size_t next_job;
+} compress_pool;
+
+static void *compress_job_run(void *arg)
+{
+	compress_job *job = arg;
+	buffer_pointers p;
+	size_t number_of_blocks = (job->src_length + 63) / 64;
+	/* compress_blocks() works in place, with the input kept at least 65
+	   bytes ahead of the output; each block grows the output by at most
+	   one byte more than it consumes (65 more for a partial last block). */
+	size_t gap = number_of_blocks + 65 + 64;
+	job->buffer = malloc(gap + job->src_length);
+	if (job->buffer == NULL) {
+		job->status = DESTINATION_FULL;
+		return NULL;
+	}
+	memcpy(job->buffer + gap, job->src, job->src_length);
+	p.dest_begin = job->buffer;
+	p.dest_end = job->buffer;
+	p.src_begin = job->buffer + gap;
+	p.src_end = job->buffer + gap + job->src_length;
+	job->status = compress_blocks(&p, job->allow_partial, job->use_bit_flip, job->cycle_limit);
+	job->dest_length = (size_t)(p.dest_end - p.dest_begin);
+	return NULL;
+}
+
+static void *compress_worker(void *arg)
+{
+	compress_pool *pool = arg;
+	size_t i;
+	while ((i = atomic_fetch_add(&pool->next_job, 1)) < pool->number_of_jobs)
+		compress_job_run(&pool->jobs[i]);
+	return NULL;
+}
+
+/* Returns the compressed data (to be freed by the caller), or NULL when
+   out of memory. */
+static uint8_t *compress_parallel(const uint8_t *src, size_t src_length, int number_of_threads, bool use_bit_flip, int cycle_limit, size_t *dest_length)
+{
+	size_t number_of_blocks = (src_length + 63) / 64;
+	size_t offset = 0;
+	size_t number_of_jobs = (number_of_blocks + BLOCKS_PER_JOB - 1) / BLOCKS_PER_JOB;
+	int number_of_workers;
+	size_t i;
+	compress_pool pool;
+	pthread_t *threads;
+	uint8_t *dest = NULL;
+	bool ok = true;
+
+	/* even an empty input makes one (empty) part */
+	if (number_of_jobs < 1)
+		number_of_jobs = 1;
+	if (number_of_threads < 1)
+		number_of_threads = 1;
+	if ((size_t)number_of_threads > number_of_jobs)
+		number_of_threads = (int)number_of_jobs;
+
+	pool.jobs = calloc(number_of_jobs, sizeof(compress_job));
+	pool.number_of_jobs = number_of_jobs;
+	atomic_init(&pool.next_job, 0);
+	threads = calloc(number_of_threads, sizeof(pthread_t));
+	if ((pool.jobs == NULL) || (threads == NULL)) {
+		free(pool.jobs);
+		free(threads);
+		return NULL;
+	}
+
+	for (i = 0; i < number_of_jobs; ++i) {
+		compress_job *job = &pool.jobs[i];
+		size_t length = BLOCKS_PER_JOB * 64;
+		if (length > src_length - offset)
+			length = src_length - offset;
+		job->src = src + offset;
+		job->src_length = length;
+		/* only the last part may end in a partial block */
+		job->allow_partial = (offset + length == src_length);
+		job->use_bit_flip = use_bit_flip;
+		job->cycle_limit = cycle_limit;
+		offset += length;
+	}
+
+	/* the other workers start first, then this thread joins them (and
+	   does all the work by itself if no thread could be started) */
+	for (number_of_workers = 1; number_of_workers < number_of_threads; ++number_of_workers) {
+		if (pthread_create(&threads[number_of_workers], NULL, compress_worker, &pool) != 0)
+			break;
+	}
+	compress_worker(&pool);
+	while (--number_of_workers > 0) {
+		pthread_join(threads[number_of_workers], NULL);
+	}
+
+	*dest_length = 0;
+	for (i = 0; i < number_of_jobs; ++i) {
+		if ((pool.jobs[i].buffer == NULL) || (pool.jobs[i].status != SOURCE_EMPTY))
+			ok = false;
+		*dest_length += pool.jobs[i].dest_length;
+	}
+
+	if (ok)
+		dest = malloc(*dest_length > 0 ? *dest_length : 1);
+	if (dest != NULL) {
+		offset = 0;
+		for (i = 0; i < number_of_jobs; ++i) {
+			memcpy(dest + offset, pool.jobs[i].buffer, pool.jobs[i].dest_length);
+			offset += pool.jobs[i].dest_length;
+		}
+	}
+
+	for (i = 0; i < number_of_jobs; ++i) {
+		free(pool.jobs[i].buffer);
+	}
+	free(pool.jobs);
+	free(threads);
+	return dest;
+}
+
+static uint8_t *read_whole_file(FILE *input_file, const char *input_filename, size_t *length)
+{
+	size_t capacity = BUF_IO_SIZE;
+	uint8_t *data = malloc(capacity);
+	*length = 0;
+	while (data != NULL) {
+		*length += fread(data + *length, sizeof(uint8_t), capacity - *length, input_file);
+		if (ferror(input_file)) {
+			fatal_perror(input_filename);
+		}
+		if (feof(input_file))
+			break;
+		capacity *= 2;
+		data = realloc(data, capacity);
+	}
+	if (data == NULL) {
+		fatal_error("Error: Out of memory.\n");
+	}
+	return data;
+}
+
+static double seconds_now(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+/* Compresses the input repeatedly for about a second, returning MB/s. */
+static double benchmark_compression(const uint8_t *src, size_t src_length, int number_of_threads, bool use_bit_flip, int cycle_limit, uint8_t **dest, size_t *dest_length)
+{
+	double start = seconds_now();
+	double elapsed;
+	long rounds = 0;
+	do {
+		free(*dest);
+		*dest = compress_parallel(src, src_length, number_of_threads, use_bit_flip, cycle_limit, dest_length);
+		if (*dest == NULL) {
+			fatal_error("Error: Out of memory.\n");
+		}
+		++rounds;
+		elapsed = seconds_now() - start;
+	} while (elapsed < 1.0);
+	return ((double)src_length * rounds) / elapsed / 1e6;
+}
+
 int main (int argc, char **argv)
 {
 	int c;
@@ -667,6 +861,8 @@ int main (int argc, char **argv)
 	bool use_stdio_for_data = false;
 	bool no_bit_flip_blocks = false;
 	bool interleaved_dont_care_bits = false;
+	bool benchmark = false;
+	long number_of_threads = sysconf(_SC_NPROCESSORS_ONLN);
 
 	int total_bytes_in = 0;
 	int total_bytes_out = 0;
@@ -697,12 +893,14 @@ int main (int argc, char **argv)
 			{"no-bit-flip", no_argument,       NULL, 'b'+256},
 			{"cycle-limit", required_argument, NULL, 'y'+256},
 			{"interleaved-dont-care-bits", no_argument, NULL, 'd'+256},
+			{"threads",     required_argument, NULL, 'j'},
+			{"benchmark",   no_argument,       NULL, 'B'+256},
 			{NULL, 0, NULL, 0}
 		};
 		/* getopt_long stores the option index here. */
 		int option_index = 0;
 
-		c = getopt_long(argc, argv, "hVzdo:cfvq",
+		c = getopt_long(argc, argv, "hVzdo:cfvqj:",
 						long_options, &option_index);
 
 		/* Detect the end of the options. */
@@ -750,6 +948,15 @@ int main (int argc, char **argv)
 		break; case 'd'+256:
 			interleaved_dont_care_bits = true;
 
+		break; case 'j':
+			number_of_threads = strtol(optarg, NULL, 0);
+			if (number_of_threads < 1) {
+				fatal_error("Invalid parameter for --threads. Must be a integer >= 1.\n");
+			}
+
+		break; case 'B'+256:
+			benchmark = true;
+
 		break; case '?':
 			/* getopt_long already printed an error message. */
 			exit(EXIT_FAILURE);
@@ -777,6 +984,35 @@ int main (int argc, char **argv)
 		++optind;
 	}
 
+	if (benchmark) {
+		uint8_t *single_dest = NULL;
+		uint8_t *multi_dest = NULL;
+		size_t single_length, multi_length;
+		double single_speed, multi_speed;
+		uint8_t *data;
+		if (input_filename == NULL) {
+			fatal_error("input filename required. Try --help for more info.\n");
+		}
+		input_file = fopen(input_filename, "rb");
+		if (input_file == NULL) {
+			fatal_perror(input_filename);
+		}
+		data = read_whole_file(input_file, input_filename, &l);
+		fclose(input_file);
+		single_speed = benchmark_compression(data, l, 1, !no_bit_flip_blocks, cycle_limit, &single_dest, &single_length);
+		multi_speed = benchmark_compression(data, l, (int)number_of_threads, !no_bit_flip_blocks, cycle_limit, &multi_dest, &multi_length);
+		printf("%s: %zu => %zu bytes\n", input_filename, l, single_length);
+		printf("  1 thread:   %8.3f MB/s\n", single_speed);
+		printf("  %-2ld threads: %8.3f MB/s (%.2fx)\n", number_of_threads, multi_speed, multi_speed / single_speed);
+		if ((single_length != multi_length) || (memcmp(single_dest, multi_dest, single_length) != 0)) {
+			fatal_error("Error: Multithreaded output differs.\n");
+		}
+		free(data);
+		free(single_dest);
+		free(multi_dest);
+		exit(EXIT_SUCCESS);
+	}
+
 	if ((input_filename == NULL) && (output_filename == NULL) && (!use_stdio_for_data)) {
 		fatal_error("Input and output filenames required. Try --help for more info.\n");
 	}
@@ -855,67 +1091,86 @@ int main (int argc, char **argv)
 		input_filename = "<stdin>";
 	}
 
-	p.src_begin = INPUT_BEGIN;
-	p.src_end = INPUT_BEGIN;
-	p.dest_begin = OUTPUT_BEGIN;
-	p.dest_end = OUTPUT_BEGIN;
-	status = SOURCE_EMPTY;
-	while(true) {
-		l = (size_t)(p.src_end - p.src_begin);
-		if ((l <= BUF_GAP_SIZE) && !feof(input_file)) {
-			if (l > 0) {
-				memmove(INPUT_BEGIN - l, p.src_begin, l);
-			}
-			p.src_begin = INPUT_BEGIN - l;
-			p.src_end = INPUT_BEGIN;
-
-			l = fread(INPUT_BEGIN, sizeof(uint8_t), (size_t)BUF_IO_SIZE, input_file);
-			if (ferror(input_file)) {
-				fatal_perror(input_filename);
-			}
-			p.src_end += l;
-			total_bytes_in += l;
+	if (!decompress && !interleaved_dont_care_bits && (number_of_threads > 1)) {
+		uint8_t *data = read_whole_file(input_file, input_filename, &l);
+		uint8_t *dest;
+		size_t dest_length;
+		total_bytes_in = (int)l;
+		dest = compress_parallel(data, l, (int)number_of_threads, !no_bit_flip_blocks, cycle_limit, &dest_length);
+		if (dest == NULL) {
+			fatal_error("Error: Out of memory.\n");
 		}
-
-		if (decompress) {
-			status = decompress_blocks(&p, feof(input_file));
-		} else if (interleaved_dont_care_bits) {
-			status = compress_blocks_with_dcb(&p, feof(input_file), !no_bit_flip_blocks, cycle_limit);
-		} else {
-			status = compress_blocks(&p, feof(input_file), !no_bit_flip_blocks, cycle_limit);
+		fwrite(dest, sizeof(uint8_t), dest_length, output_file);
+		if (ferror(output_file)) {
+			fatal_perror(output_filename);
 		}
+		total_bytes_out = (int)dest_length;
+		free(data);
+		free(dest);
+		status = SOURCE_EMPTY;
+	} else {
+		p.src_begin = INPUT_BEGIN;
+		p.src_end = INPUT_BEGIN;
+		p.dest_begin = OUTPUT_BEGIN;
+		p.dest_end = OUTPUT_BEGIN;
+		status = SOURCE_EMPTY;
+		while(true) {
+			l = (size_t)(p.src_end - p.src_begin);
+			if ((l <= BUF_GAP_SIZE) && !feof(input_file)) {
+				if (l > 0) {
+					memmove(INPUT_BEGIN - l, p.src_begin, l);
+				}
+				p.src_begin = INPUT_BEGIN - l;
+				p.src_end = INPUT_BEGIN;
 
-		l = (size_t)(p.dest_end - p.dest_begin);
-		if (l >= BUF_IO_SIZE) {
-			l = fwrite(p.dest_begin, sizeof(uint8_t), (size_t)BUF_IO_SIZE, output_file);
-			if (ferror(output_file)) {
-				fatal_perror(output_filename);
+				l = fread(INPUT_BEGIN, sizeof(uint8_t), (size_t)BUF_IO_SIZE, input_file);
+				if (ferror(input_file)) {
+					fatal_perror(input_filename);
+				}
+				p.src_end += l;
+				total_bytes_in += l;
 			}
-			p.dest_begin += l;
-			total_bytes_out += l;
 
-			l = (size_t)(p.dest_end - p.dest_begin);
-			if (l > 0) {
-				memmove(OUTPUT_BEGIN, p.dest_begin, l);
+			if (decompress) {
+				status = decompress_blocks(&p, feof(input_file));
+			} else if (interleaved_dont_care_bits) {
+				status = compress_blocks_with_dcb(&p, feof(input_file), !no_bit_flip_blocks, cycle_limit);
+			} else {
+				status = compress_blocks(&p, feof(input_file), !no_bit_flip_blocks, cycle_limit);
 			}
-			p.dest_begin = OUTPUT_BEGIN;
-			p.dest_end = OUTPUT_BEGIN + l;
-		}
 
-		if ((feof(input_file) && (status == SOURCE_EMPTY)) || (status == ENCOUNTERED_UNDEFINED_BLOCK)) {
 			l = (size_t)(p.dest_end - p.dest_begin);
-			if (l > 0) {
-				l = fwrite(p.dest_begin, sizeof(uint8_t), (size_t)l, output_file);
+			if (l >= BUF_IO_SIZE) {
+				l = fwrite(p.dest_begin, sizeof(uint8_t), (size_t)BUF_IO_SIZE, output_file);
 				if (ferror(output_file)) {
-					fatal_error(output_filename);
+					fatal_perror(output_filename);
 				}
 				p.dest_begin += l;
 				total_bytes_out += l;
+
+				l = (size_t)(p.dest_end - p.dest_begin);
+				if (l > 0) {
+					memmove(OUTPUT_BEGIN, p.dest_begin, l);
+				}
+				p.dest_begin = OUTPUT_BEGIN;
+				p.dest_end = OUTPUT_BEGIN + l;
 			}
-			if (status == ENCOUNTERED_UNDEFINED_BLOCK) {
-				fatal_error("Error: Unhandled block header >= 0xc0.\n");
+
+			if ((feof(input_file) && (status == SOURCE_EMPTY)) || (status == ENCOUNTERED_UNDEFINED_BLOCK)) {
+				l = (size_t)(p.dest_end - p.dest_begin);
+				if (l > 0) {
+					l = fwrite(p.dest_begin, sizeof(uint8_t), (size_t)l, output_file);
+					if (ferror(output_file)) {
+						fatal_error(output_filename);
+					}
+					p.dest_begin += l;
+					total_bytes_out += l;
+				}
+				if (status == ENCOUNTERED_UNDEFINED_BLOCK) {
+					fatal_error("Error: Unhandled block header >= 0xc0.\n");
+				}
+				break;
 			}
-			break;
 		}
 	}
 
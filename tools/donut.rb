@@ -0,0 +1,80 @@
+# frozen_string_literal: true
+
+# Helpers for walking Donut streams (see src/donut.s for the format)
+module Donut
+  SHORTHAND_PLANE_DEFS = [0x00, 0x55, 0xaa, 0xff].freeze
+
+  # Size, in bytes, of the encoded block starting at data[index]
+  def self.block_length(data, index)
+    header = data[index]
+    return 65 if header == 0x2a
+
+    length = 1
+    if header.anybits?(0x02)
+      plane_def = data[index + length]
+      length += 1
+      if header.anybits?(0x04)
+        return length if plane_def.zero?
+
+        return length + 1 + popcount(data[index + length])
+      end
+    else
+      plane_def = SHORTHAND_PLANE_DEFS[(header & 0x0c) >> 2]
+    end
+    popcount(plane_def).times do
+      length += 1 + popcount(data[index + length])
+    end
+    length
+  end
+
+  # Offsets of each block in a stream
+  def self.block_offsets(data)
+    offsets = []
+    index = 0
+    while index < data.size
+      offsets << index
+      index += block_length(data, index)
+    end
+    offsets
+  end
+
+  # Estimated cycles for decoding and uploading a stream; port of cblock_cost
+  # from donut.c, plus the upload loop (fitted against src/donut.s)
+  def self.cycles(data)
+    block_offsets(data).sum do |index|
+      header = data[index]
+      next 837 + 1268 if header == 0x2a
+
+      total = 837 + 1298
+      total += 640 if header.anybits?(0xc0)
+      total += 4 if header.anybits?(0x20)
+      total += 4 if header.anybits?(0x10)
+      position = index + 1
+      if header.anybits?(0x02)
+        plane_def = data[position]
+        position += 1
+        total += 5
+        only_one_plane = header.anybits?(0x04) && plane_def != 0
+      else
+        plane_def = SHORTHAND_PLANE_DEFS[(header & 0x0c) >> 2]
+        only_one_plane = false
+      end
+      planes = popcount(plane_def)
+      total += header.anybits?(0x01) ? planes * 614 : planes * 75
+      if only_one_plane
+        total += planes + (popcount(data[position]) * 6 * planes)
+      else
+        planes.times do
+          plane_size = popcount(data[position])
+          position += 1 + plane_size
+          total += plane_size * 6
+        end
+      end
+      total
+    end
+  end
+
+  def self.popcount(byte)
+    byte.digits(2).sum
+  end
+end
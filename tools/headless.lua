@@ -0,0 +1,103 @@
+-- Drives a HEADLESS build (see src/movie.hpp): each gameplay run reads a
+-- movie (as recorded by tools/log.lua) from $4028, and reports how it went
+-- to $4029, which ends up in headless-results.csv in the script's data
+-- folder. Mesen needs I/O access for the script; its test runner goes as
+-- fast as the host allows, e.g.
+--   Mesen --testrunner miroh-jr.nes headless.lua
+
+-- movies to play, in order; when empty, movie-1.bin, movie-2.bin... from
+-- the script's data folder are played until one is missing
+movies = {}
+
+movie_index = 0
+movie_name = nil
+movie_bytes = nil
+movie_position = 1
+
+result_bytes = {}
+results = { "movie,cheats,stage,mode,gameplay_state,level,score,goal_counter,steps,lines,overflowed" }
+
+-- gameplay states, in the same order as Gameplay::GameplayState
+gameplay_state_names = {
+  [0] = "playing", [1] = "swapping", [2] = "paused", [3] = "confirm exit",
+  [4] = "confirm retry", [5] = "confirm continue", [6] = "retry or exit",
+  [7] = "retrying", [8] = "marshmallow overflow"
+}
+
+function load_next_movie()
+  movie_index = movie_index + 1
+  local path = movies[movie_index]
+  if #movies == 0 then
+    path = emu.getScriptDataFolder() .. "/movie-" .. movie_index .. ".bin"
+  end
+  movie_name = path
+  movie_bytes = nil
+  movie_position = 1
+  if path == nil then
+    return false
+  end
+  local file = io.open(path, "rb")
+  if file == nil then
+    return false
+  end
+  movie_name = string.match(path, "[^/\\]+$") or path
+  movie_bytes = file:read("a")
+  file:close()
+  return true
+end
+
+-- past the end of a movie there's a 0 frames run, which ends the run
+function stream_read(_address, _value)
+  if movie_bytes == nil or movie_position > #movie_bytes then
+    return 0
+  end
+  local byte = string.byte(movie_bytes, movie_position)
+  movie_position = movie_position + 1
+  return byte
+end
+
+-- the cheats byte of the movie's header, as CHEAT_* bits (src/movie.hpp)
+function movie_cheats()
+  if movie_bytes == nil or #movie_bytes < 4 then
+    return 0
+  end
+  return string.byte(movie_bytes, 4)
+end
+
+function result_cb(_address, value)
+  table.insert(result_bytes, value)
+  if #result_bytes < 12 then
+    return
+  end
+
+  local r = result_bytes
+  result_bytes = {}
+  local score = tonumber(string.format("%x%02x", r[5], r[6]))
+  table.insert(results, table.concat({
+    movie_name, movie_cheats(), r[1], r[2], gameplay_state_names[r[3]] or r[3], r[4], score, r[7], r[8] * 256 + r[9],
+    r[10] * 256 + r[11], r[12]
+  }, ","))
+
+  if not load_next_movie() then
+    finish()
+  end
+end
+
+function finish()
+  local file = io.open(emu.getScriptDataFolder() .. "/headless-results.csv", "w")
+  file:write(table.concat(results, "\n") .. "\n")
+  file:close()
+  emu.log("Played " .. (#results - 1) .. " runs")
+  emu.stop(0)
+end
+
+if io == nil then
+  emu.log("headless.lua needs I/O access, to read movies and write results")
+  emu.stop(1)
+elseif not load_next_movie() then
+  emu.log("No movies to play")
+  emu.stop(1)
+end
+
+emu.addMemoryCallback(stream_read, emu.callbackType.read, 0x4028)
+emu.addMemoryCallback(result_cb, emu.callbackType.write, 0x4029)
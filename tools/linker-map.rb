@@ -0,0 +1,183 @@
+# frozen_string_literal: true
+
+require 'wtf8-fixer'
+
+# Reads llvm-mos linker .map files
+module LinkerMap
+  # layout of ram and rom areas
+  class Layout
+    attr_reader :areas
+
+    def initialize(areas)
+      @areas = areas
+    end
+
+    def self.build_action53(banks:)
+      areas = [
+        Area.new('Zero Page', 0x00...0x100),
+        Area.new('RAM', 0x200...0x800)
+      ]
+
+      (0..(banks - 1)).each do |bank|
+        areas << Area.new("PRG ROM #{bank}",
+                          (0x8000 + (0x10000 * bank))...(0xc000 + (0x10000 * bank)))
+      end
+
+      areas << Area.new('PRG ROM Last', 0xc000...0x10000)
+
+      new(areas)
+    end
+
+    def self.build_mmc3(banks:, chr_banks:)
+      areas = [
+        Area.new('Zero Page', 0x00...0x100),
+        Area.new('RAM', 0x100...0x800),
+        Area.new('WRAM', 0x6000...0x8000)
+      ]
+
+      (0...(banks - 2)).each do |bank|
+        areas << Area.new("PRG ROM #{bank}",
+                          (0x8000 + (0x10000 * bank))...(0xa000 + (0x10000 * bank)))
+      end
+
+      areas << Area.new('PRG ROM Fix', 0xa000...0xc000)
+      areas << Area.new('PRG ROM Last', 0xc000...0x10000)
+
+      areas << Area.new('CHR ROM', 0x1000000...(0x1000000 + (0x2000 * chr_banks)))
+
+      new(areas)
+    end
+
+    class Area
+      attr_reader :range, :name
+
+      def initialize(name, range)
+        @name = name
+        @range = range
+      end
+    end
+  end
+
+  # .map contents in an structured format
+  class Map
+    attr_reader :areas
+
+    def initialize(areas)
+      @areas = areas
+    end
+
+    def self.read(file:, layout:)
+      areas = layout.areas.map { |area| Area.new(area) }
+      current_vma_area = nil
+      current_lma_area = nil
+      current_vma_out_section = nil
+      current_lma_out_section = nil
+      current_vma_in_section = nil
+      current_lma_in_section = nil
+      File.read(file).then { |content| WTF8Fixer.fix(content) }.lines(chomp: true).drop(1).each do |line|
+        match = line.match(/\A(?<vma>.{8})\s
+                              (?<lma>.{8})\s
+                              (?<size>.{8})\s(?<align>.{5})\s
+                              (?:
+                              (?<out>\S.*)|
+                              \s{8}(?<in>\S.*)|
+                              \s{16}(?<sym>\S.*)
+                              )/x)
+        next unless match
+
+        vma = match['vma'].to_i(16)
+        lma = match['lma'].to_i(16)
+        size = match['size'].to_i(16)
+
+        if (out_name = match['out'])
+          next if out_name.include?(' = ') || out_name =~ /\A\s*\z/
+
+          current_vma_area = areas.find { |area| area.range.include? vma }
+          next unless current_vma_area
+
+          current_vma_out_section = OutSection.new(name: out_name,
+                                                   used_range: vma...(vma + size))
+
+          unless /\A\.(?:debug|symtab|shstrtab|strtab|comment)/.match?(out_name)
+            current_vma_area.out_sections << current_vma_out_section
+          end
+
+          if lma != vma
+            current_lma_area = areas.find { |area| area.range.include? lma }
+            next unless current_lma_area
+
+            current_lma_out_section = OutSection.new(name: out_name,
+                                                     used_range: lma...(lma + size))
+            current_lma_area.out_sections << current_lma_out_section
+
+          end
+        elsif (in_name = match['in'])
+          current_vma_in_section = InSection.new(name: in_name,
+                                                 used_range: vma...(vma + size))
+          current_vma_out_section.in_sections << current_vma_in_section
+          if lma != vma
+            current_lma_in_section = InSection.new(name: in_name,
+                                                   used_range: lma...(lma + size))
+            current_lma_out_section.in_sections << current_lma_in_section
+          end
+        elsif (sym_name = match['sym'])
+          current_vma_in_section.symbols << Symbol.new(name: sym_name, used_range: vma...(vma + size))
+          current_lma_in_section.symbols << Symbol.new(name: sym_name, used_range: lma...(lma + size)) if lma != vma
+        end
+      end
+
+      Map.new(areas)
+    end
+
+    class Area
+      attr_reader :name, :range, :out_sections
+
+      def initialize(layout_area)
+        @name = layout_area.name
+        @range = layout_area.range
+        @out_sections = []
+      end
+    end
+
+    class OutSection
+      attr_reader :name, :used_range, :in_sections
+
+      def initialize(name:, used_range:)
+        @name = name
+        @used_range = used_range
+        @in_sections = []
+      end
+
+      def usage
+        used_range.end - used_range.begin
+      end
+    end
+
+    class InSection
+      attr_reader :name, :used_range, :symbols
+
+      def initialize(name:, used_range:)
+        @name = name
+        @used_range = used_range
+        @symbols = []
+      end
+
+      def usage
+        used_range.end - used_range.begin
+      end
+    end
+
+    class Symbol
+      attr_accessor :name, :used_range
+
+      def initialize(name:, used_range:)
+        @name = name
+        @used_range = used_range
+      end
+
+      def usage
+        used_range.end - used_range.begin
+      end
+    end
+  end
+end
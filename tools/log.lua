@@ -5,14 +5,73 @@ watch_table = {
 }
 current_watch = {}
 label_stack = {}
-label_latch = false
-label_address = 0
+-- watches labeled "nmi ..." run from the NMI handler, whatever watch it
+-- interrupted; they start a tree of their own, and the interrupted stack
+-- waits here until they stop
+interrupted_stacks = {}
+-- watch ids are indexes into this table, which tools/watch-labels puts in
+-- front of this script as the build's log.lua
+watch_labels = watch_labels or {}
 
 display_toggle = 0  -- 0: no display, 1: less transparent, 2: more transparent
 left_mouse_prev_state = false
 
 frame_start_cycle = 0
 
+-- bank switch profiling (see BANK_SWITCH_PROFILE in src/bank-helper.hpp)
+bank_switch_file_latch = false
+bank_switch_file_address = 0
+bank_switch_line_latch = false
+bank_switch_line = 0
+bank_switch_sites = {}
+mapper_writes = 0 -- every bank switch this frame, including restores
+mapped_bank = nil -- the last bank written, i.e. the caller's when a switch is reported
+last_frame_mapper_writes = 0
+max_frame_mapper_writes = 0
+profiled_frames = 0
+
+-- gameplay frames whose logic overran into the next one (see
+-- LOG_LAG_FRAME; the title screen and world map don't report any), by
+-- game state, its sub-state and the innermost watch running when vblank
+-- came; exported as lag-frames.csv
+lag_frames = 0
+lag_game_state = nil -- latched from the first of the two port writes
+lag_overrun = nil -- watch path running at the last vblank that hit one
+lag_counts = {} -- "game state/sub-state/watch path" => { frames, ... }
+-- names for the ids written to the port; keep them in the same order as
+-- GameState (src/common.hpp) and Gameplay::GameplayState (src/gameplay.hpp)
+game_state_names = { [0] = "title", [1] = "world map", [2] = "gameplay" }
+sub_state_names = {
+  gameplay = {
+    [0] = "playing", [1] = "swapping", [2] = "paused", [3] = "confirm exit",
+    [4] = "confirm retry", [5] = "confirm continue", [6] = "retry or exit",
+    [7] = "retrying", [8] = "marshmallow overflow"
+  }
+}
+
+-- input movies from INPUT_MOVIE=RECORD builds (see src/movie.hpp), written
+-- as movie-N.bin for INPUT_MOVIE_FILE
+movie_bytes = nil -- header, then runs of frames, pad 0, pad 1
+movie_header_left = 0
+movie_run_byte = 0 -- position within the current run
+movie_count = 0
+
+-- headless profiling: with export_profile set, the cycles of every watch
+-- (by its path in the watch tree) are recorded each frame and summarized
+-- into watch-profile.json and watch-profile.csv when the script ends. A
+-- profile_frame_limit above 0 ends the run after that many frames, e.g.
+--   Mesen --testrunner miroh-jr.nes log.lua (the build's copy, with labels)
+export_profile = false
+profile_frame_limit = 0
+profile_histogram_bucket = 1000 -- cycles
+profile_samples = {} -- path => list of per-frame cycles
+profile_frame = {} -- path => cycles in the current frame
+profile_frame_order = {} -- paths in the current frame, as they stopped
+profile_frame_total = 0
+profile_worst = nil -- { frame, cycles, stack = { { path, cycles } } }
+profile_frames = 0
+profile_exported = false
+
 function reset_hits(subtable)
   if subtable.hits ~= nil then
     subtable.hits = 0
@@ -25,6 +84,78 @@ end
 function get_start_frame_cycle_count()
   frame_start_cycle = emu.getState()['cpu.cycleCount']
   reset_hits(watch_table)
+  bank_switch_new_frame()
+  if export_profile then
+    profile_new_frame()
+  end
+end
+
+function profile_new_frame()
+  if #profile_frame_order == 0 then
+    return
+  end
+  profile_frames = profile_frames + 1
+  local stack = {}
+  for _, path in ipairs(profile_frame_order) do
+    table.insert(profile_samples[path], profile_frame[path])
+    table.insert(stack, { path = path, cycles = profile_frame[path] })
+  end
+  if profile_worst == nil or profile_frame_total > profile_worst.cycles then
+    profile_worst = {
+      frame = emu.getState()['frameCount'] - 1,
+      cycles = profile_frame_total,
+      stack = stack
+    }
+  end
+  profile_frame = {}
+  profile_frame_order = {}
+  profile_frame_total = 0
+  if profile_frame_limit > 0 and profile_frames >= profile_frame_limit then
+    export_watch_profile()
+    emu.stop(0)
+  end
+end
+
+function is_nmi_watch(label)
+  return string.sub(label, 1, 4) == "nmi "
+end
+
+-- stop_watch runs with the label already popped from label_stack
+function profile_watch(label, cycles)
+  local path = table.concat(label_stack, "/")
+  if path == "" then
+    path = label
+    -- NMI cycles already count in the watch the NMI interrupted, if any
+    local interrupted = interrupted_stacks[#interrupted_stacks]
+    if not is_nmi_watch(label) or interrupted == nil or #interrupted == 0 then
+      profile_frame_total = profile_frame_total + cycles
+    end
+  else
+    path = path .. "/" .. label
+  end
+  if profile_samples[path] == nil then
+    profile_samples[path] = {}
+  end
+  if profile_frame[path] == nil then
+    profile_frame[path] = 0
+    table.insert(profile_frame_order, path)
+  end
+  profile_frame[path] = profile_frame[path] + cycles
+end
+
+function bank_switch_new_frame()
+  if mapper_writes == 0 and next(bank_switch_sites) == nil then
+    return
+  end
+  profiled_frames = profiled_frames + 1
+  last_frame_mapper_writes = mapper_writes
+  if mapper_writes > max_frame_mapper_writes then
+    max_frame_mapper_writes = mapper_writes
+  end
+  mapper_writes = 0
+  for _, site in pairs(bank_switch_sites) do
+    site.calls = 0
+  end
 end
 
 function putchar_cb(address, value)
@@ -41,23 +172,15 @@ function putchar_cb(address, value)
   end
 end
 
-function start_watch(_address, label_byte)
-  if label_latch then
-    label_latch = false
-    label_address = label_address * 256 + label_byte
-    label = ""
-    while true do
-      local byte = emu.read(label_address, emu.memType.nesMemory, false)
-      if byte == 0 then
-        break
-      end
-      label = label .. string.char(byte)
-      label_address = label_address + 1
-    end
-  else
-    label_latch = true
-    label_address = label_byte
-    return
+function watch_label(id)
+  return watch_labels[id] or ("watch " .. id)
+end
+
+function start_watch(_address, id)
+  local label = watch_label(id)
+  if is_nmi_watch(label) then
+    table.insert(interrupted_stacks, label_stack)
+    label_stack = {}
   end
   current_watch = watch_table
   for k, v in ipairs(label_stack) do
@@ -86,24 +209,8 @@ function start_watch(_address, label_byte)
   table.insert(label_stack, label)
 end
 
-function stop_watch(_address, label_byte)
-  if label_latch then
-    label_latch = false
-    label_address = label_address * 256 + label_byte
-    label = ""
-    while true do
-      local byte = emu.read(label_address, emu.memType.nesMemory, false)
-      if byte == 0 then
-        break
-      end
-      label = label .. string.char(byte)
-      label_address = label_address + 1
-    end
-  else
-    label_latch = true
-    label_address = label_byte
-    return
-  end
+function stop_watch(_address, id)
+  local label = watch_label(id)
   current_watch = watch_table
   for k, v in ipairs(label_stack) do
     current_watch = current_watch.children[v]
@@ -117,10 +224,18 @@ function stop_watch(_address, label_byte)
 
   local new_cycles = emu.getState()['cpu.cycleCount'] - current_watch.start
   local frames = emu.getState()['frameCount'] - current_watch.start_frame
+  if export_profile then
+    profile_watch(label, new_cycles)
+  end
   if emu.getMouseState().right then
     current_watch.cycles = 0
   end
-  if frames > 0 then
+  if string.sub(label, 1, 1) == "#" then
+    emu.log(string.sub(label, 2) .. ": " .. new_cycles .. " cycles")
+    if new_cycles > current_watch.cycles then
+      current_watch.cycles = new_cycles
+    end
+  elseif frames > 0 then
     emu.log("Warning: watch label '" .. label .. "' crossed " .. frames .. " frames (" .. new_cycles .. " cycles, starting at " .. current_watch.relative_start .. " cycles from beginning of its frame)")
     emu.log("Current frame: " .. emu.getState()['frameCount'])
     for k, v in ipairs(label_stack) do
@@ -129,6 +244,275 @@ function stop_watch(_address, label_byte)
   elseif new_cycles > current_watch.cycles then
     current_watch.cycles = new_cycles
   end
+  if is_nmi_watch(label) and #interrupted_stacks > 0 then
+    label_stack = table.remove(interrupted_stacks)
+  end
+end
+
+function read_string(address)
+  local result = ""
+  while true do
+    local byte = emu.read(address, emu.memType.nesMemory, false)
+    if byte == 0 then
+      break
+    end
+    result = result .. string.char(byte)
+    address = address + 1
+  end
+  return result
+end
+
+function bank_switch_file_cb(_address, value)
+  if bank_switch_file_latch then
+    bank_switch_file_address = bank_switch_file_address * 256 + value
+  else
+    bank_switch_file_address = value
+  end
+  bank_switch_file_latch = not bank_switch_file_latch
+end
+
+function bank_switch_line_cb(_address, value)
+  if bank_switch_line_latch then
+    bank_switch_line = bank_switch_line * 256 + value
+  else
+    bank_switch_line = value
+  end
+  bank_switch_line_latch = not bank_switch_line_latch
+end
+
+-- the caller's bank is still mapped, so its file name can be read; the
+-- caller's bank tells apart the halves of files split across banks
+function bank_switch_cb(_address, bank)
+  local file = read_string(bank_switch_file_address)
+  local site = (string.match(file, "[^/\\]+$") or file) .. ":" .. bank_switch_line
+  local key = site .. "@" .. tostring(mapped_bank) .. ">" .. bank
+  if bank_switch_sites[key] == nil then
+    bank_switch_sites[key] = {
+      site = site,
+      caller_bank = mapped_bank,
+      bank = bank,
+      calls = 0,
+      max_calls = 0,
+      total = 0
+    }
+  end
+  local entry = bank_switch_sites[key]
+  entry.calls = entry.calls + 1
+  entry.total = entry.total + 1
+  if entry.calls > entry.max_calls then
+    entry.max_calls = entry.calls
+  end
+end
+
+-- logic still inside a watch when vblank comes is running late; whichever
+-- watch that was gets the blame if the game then reports a lag frame
+function lag_nmi_cb()
+  if #label_stack > 0 then
+    lag_overrun = table.concat(label_stack, "/")
+  end
+end
+
+function lag_frame_cb(_address, value)
+  if lag_game_state == nil then
+    lag_game_state = value
+    return
+  end
+  local game_state = game_state_names[lag_game_state] or ("state " .. lag_game_state)
+  local sub_states = sub_state_names[game_state] or {}
+  local sub_state = sub_states[value] or tostring(value)
+  local overrun = lag_overrun or "?"
+  lag_game_state = nil
+  lag_overrun = nil
+
+  lag_frames = lag_frames + 1
+  local key = game_state .. "/" .. sub_state .. "/" .. overrun
+  if lag_counts[key] == nil then
+    lag_counts[key] = { game_state = game_state, sub_state = sub_state, overrun = overrun, frames = 0 }
+  end
+  lag_counts[key].frames = lag_counts[key].frames + 1
+  emu.log("Lag frame #" .. lag_frames .. " (frame " .. emu.getState()['frameCount'] .. ", " ..
+    game_state .. "/" .. sub_state .. ", overran in " .. overrun .. ")")
+end
+
+function sorted_lag_counts()
+  local entries = {}
+  for _, entry in pairs(lag_counts) do
+    table.insert(entries, entry)
+  end
+  table.sort(entries, function(a, b)
+    return a.frames > b.frames
+  end)
+  return entries
+end
+
+function export_lag_frames()
+  if lag_frames == 0 then
+    return
+  end
+  local lines = { "game_state,sub_state,overrun,frames" }
+  for _, entry in ipairs(sorted_lag_counts()) do
+    table.insert(lines, entry.game_state .. "," .. entry.sub_state .. "," .. entry.overrun .. "," .. entry.frames)
+  end
+  write_output("lag-frames.csv", lines)
+end
+
+function movie_header_cb(_address, value)
+  if movie_header_left == 0 then
+    movie_bytes = {}
+    movie_header_left = 6
+    movie_run_byte = 0
+  end
+  table.insert(movie_bytes, value)
+  movie_header_left = movie_header_left - 1
+end
+
+-- a run of 0 frames ends the movie
+function movie_run_cb(_address, value)
+  if movie_bytes == nil then
+    return
+  end
+  if movie_run_byte == 0 and value == 0 then
+    table.insert(movie_bytes, 0)
+    export_movie()
+    movie_bytes = nil
+    return
+  end
+  table.insert(movie_bytes, value)
+  movie_run_byte = (movie_run_byte + 1) % 3
+end
+
+function export_movie()
+  movie_count = movie_count + 1
+  local name = "movie-" .. movie_count .. ".bin"
+  local file = nil
+  if io ~= nil then
+    file = io.open(emu.getScriptDataFolder() .. "/" .. name, "wb")
+  end
+  if file == nil then
+    local hex = {}
+    for _, byte in ipairs(movie_bytes) do
+      table.insert(hex, string.format("%02x", byte))
+    end
+    emu.log(name .. " (enable I/O access to write it as a file):")
+    emu.log(table.concat(hex, " "))
+    return
+  end
+  -- in chunks, to stay within Lua's stack for unpack
+  for i = 1, #movie_bytes, 1024 do
+    file:write(string.char(table.unpack(movie_bytes, i, math.min(i + 1023, #movie_bytes))))
+  end
+  file:close()
+  emu.log("Wrote " .. name .. " (" .. #movie_bytes .. " bytes)")
+end
+
+function mapper_write(_address, value)
+  mapper_writes = mapper_writes + 1
+  mapped_bank = value
+end
+
+-- writes lines into the script's data folder, or to the log when Mesen
+-- doesn't allow I/O access
+function write_output(name, lines)
+  local file = nil
+  if io ~= nil then
+    file = io.open(emu.getScriptDataFolder() .. "/" .. name, "w")
+  end
+  if file == nil then
+    emu.log(name .. " (enable I/O access to write it as a file):")
+    for _, line in ipairs(lines) do
+      emu.log(line)
+    end
+    return
+  end
+  file:write(table.concat(lines, "\n") .. "\n")
+  file:close()
+end
+
+-- writes tools/bank-placer's profile: site,target_bank,calls,caller_bank
+-- (caller_bank is empty for switches before the first mapper write)
+function export_bank_switches()
+  if profiled_frames == 0 then
+    return
+  end
+  local lines = { "# frames: " .. profiled_frames, "site,target_bank,calls,caller_bank" }
+  for _, entry in pairs(bank_switch_sites) do
+    table.insert(lines, entry.site .. "," .. entry.bank .. "," .. entry.total .. "," .. (entry.caller_bank or ""))
+  end
+  write_output("bank-switches.csv", lines)
+end
+
+function percentile(sorted, fraction)
+  local index = math.ceil(#sorted * fraction)
+  if index < 1 then
+    index = 1
+  end
+  return sorted[index]
+end
+
+function json_string(value)
+  return '"' .. string.gsub(value, '[%c"\\]', function(c)
+    return string.format("\\u%04x", string.byte(c))
+  end) .. '"'
+end
+
+function export_watch_profile()
+  if profile_exported or profile_frames == 0 then
+    return
+  end
+  profile_exported = true
+
+  local paths = {}
+  for path, _ in pairs(profile_samples) do
+    table.insert(paths, path)
+  end
+  table.sort(paths)
+
+  local csv = { "path,frames,p50,p95,max" }
+  local json = { "{", '  "frames": ' .. profile_frames .. ",", '  "histogram_bucket": ' .. profile_histogram_bucket .. ",", '  "labels": {' }
+  for i, path in ipairs(paths) do
+    local sorted = {}
+    local histogram = {}
+    for _, cycles in ipairs(profile_samples[path]) do
+      table.insert(sorted, cycles)
+      local bucket = math.floor(cycles / profile_histogram_bucket)
+      histogram[bucket] = (histogram[bucket] or 0) + 1
+    end
+    table.sort(sorted)
+    local p50 = percentile(sorted, 0.5)
+    local p95 = percentile(sorted, 0.95)
+    local max = sorted[#sorted]
+    table.insert(csv, path .. "," .. #sorted .. "," .. p50 .. "," .. p95 .. "," .. max)
+
+    local buckets = {}
+    for bucket, count in pairs(histogram) do
+      table.insert(buckets, bucket)
+    end
+    table.sort(buckets)
+    local histogram_entries = {}
+    for _, bucket in ipairs(buckets) do
+      table.insert(histogram_entries, '"' .. bucket * profile_histogram_bucket .. '": ' .. histogram[bucket])
+    end
+    table.insert(json, "    " .. json_string(path) .. ": { " ..
+      '"frames": ' .. #sorted .. ', "p50": ' .. p50 .. ', "p95": ' .. p95 .. ', "max": ' .. max ..
+      ', "histogram": { ' .. table.concat(histogram_entries, ", ") .. " } }" ..
+      (i < #paths and "," or ""))
+  end
+  table.insert(json, "  },")
+
+  local stack_entries = {}
+  for _, entry in ipairs(profile_worst.stack) do
+    table.insert(stack_entries, "      { \"path\": " .. json_string(entry.path) .. ', "cycles": ' .. entry.cycles .. " }")
+  end
+  table.insert(json, '  "worst_frame": {')
+  table.insert(json, '    "frame": ' .. profile_worst.frame .. ', "cycles": ' .. profile_worst.cycles .. ",")
+  table.insert(json, '    "stack": [')
+  table.insert(json, table.concat(stack_entries, ",\n"))
+  table.insert(json, "    ]")
+  table.insert(json, "  }")
+  table.insert(json, "}")
+
+  write_output("watch-profile.csv", csv)
+  write_output("watch-profile.json", json)
 end
 
 display_stack = {}
@@ -157,6 +541,64 @@ function recursive_display(subtable, x, y, width)
   return rect.height + 1
 end
 
+-- top call sites by their worst frame; each switch costs two mapper writes
+function bank_switch_display(x, y, width)
+  if max_frame_mapper_writes == 0 then
+    return
+  end
+  local rect = {
+    x = x,
+    y = y,
+    width = width,
+    height = 11,
+    label = "banks " .. last_frame_mapper_writes .. " max " .. max_frame_mapper_writes
+  }
+  local entries = {}
+  for _, entry in pairs(bank_switch_sites) do
+    table.insert(entries, entry)
+  end
+  table.sort(entries, function(a, b)
+    return a.max_calls > b.max_calls
+  end)
+  local rows = {}
+  for i = 1, math.min(#entries, 8) do
+    local entry = entries[i]
+    table.insert(rows, {
+      x = x + 4,
+      y = y + rect.height - 2,
+      width = width - 6,
+      height = 9,
+      label = entry.site .. ">" .. entry.bank .. " x" .. entry.max_calls
+    })
+    rect.height = rect.height + 8
+  end
+  table.insert(display_stack, rect)
+  for i = #rows, 1, -1 do
+    table.insert(display_stack, 1, rows[i])
+  end
+end
+
+-- total lag frames and the worst offenders, growing upwards from y
+function lag_display(x, y, width)
+  if lag_frames == 0 then
+    return
+  end
+  local entries = sorted_lag_counts()
+  local rows = math.min(#entries, 3)
+  y = y - rows * 8
+  table.insert(display_stack, 1, { x = x, y = y, width = width, height = 11 + rows * 8, label = "lag " .. lag_frames })
+  for i = 1, rows do
+    local entry = entries[i]
+    table.insert(display_stack, 1, {
+      x = x + 4,
+      y = y + 1 + i * 8,
+      width = width - 6,
+      height = 9,
+      label = entry.sub_state .. " " .. entry.overrun .. " x" .. entry.frames
+    })
+  end
+end
+
 function display_times()
   left_mouse_state = emu.getMouseState().left
   if left_mouse_state ~= left_mouse_prev_state then
@@ -172,6 +614,8 @@ function display_times()
 
   display_stack = {}
   recursive_display(watch_table, 4, 4, 112)
+  bank_switch_display(136, 4, 116)
+  lag_display(4, 220, 248)
 
   while #display_stack ~= 0 do
     rect = table.remove(display_stack)
@@ -202,5 +646,16 @@ emu.addMemoryCallback(putchar_cb, emu.callbackType.write, 0x401b)
 emu.addMemoryCallback(break_point, emu.callbackType.write, 0x4019)
 emu.addMemoryCallback(start_watch, emu.callbackType.write, 0x4020)
 emu.addMemoryCallback(stop_watch, emu.callbackType.write, 0x4021)
+emu.addMemoryCallback(bank_switch_file_cb, emu.callbackType.write, 0x4022)
+emu.addMemoryCallback(bank_switch_line_cb, emu.callbackType.write, 0x4023)
+emu.addMemoryCallback(bank_switch_cb, emu.callbackType.write, 0x4024)
+emu.addMemoryCallback(lag_frame_cb, emu.callbackType.write, 0x4025)
+emu.addMemoryCallback(movie_header_cb, emu.callbackType.write, 0x4026)
+emu.addMemoryCallback(movie_run_cb, emu.callbackType.write, 0x4027)
+emu.addMemoryCallback(mapper_write, emu.callbackType.write, 0x8000, 0xffff)
 emu.addEventCallback(display_times, emu.eventType.endFrame);
+emu.addEventCallback(lag_nmi_cb, emu.eventType.nmi);
+emu.addEventCallback(export_bank_switches, emu.eventType.scriptEnded);
+emu.addEventCallback(export_lag_frames, emu.eventType.scriptEnded);
+emu.addEventCallback(export_watch_profile, emu.eventType.scriptEnded);
 emu.addEventCallback(get_start_frame_cycle_count, emu.eventType.startFrame);
\ No newline at end of file